@@ -5,308 +5,3241 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <string_view>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <cctype>
+#include <atomic>
+#include <future>
+#include <deque>
+#include <array>
+#include <iomanip>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <set>
 
 using namespace std;
 
-class DatabaseManager {
-public:
+// Statement cache class - bounded LRU of prepared statements owned by one connection,
+// keyed by whitespace-normalized SQL text
+class StatementCache {
+private:
+    struct Entry {
+        string sql;
+        sqlite3_stmt* stmt;
+        bool inUse;
+    };
+    
     sqlite3* db;
-    bool initialized;
-    map<string, sqlite3_stmt*> preparedStatements;
+    size_t capacity;
+    list<Entry> lru;
+    unordered_map<string, list<Entry>::iterator> bySql;
+    unordered_map<sqlite3_stmt*, list<Entry>::iterator> byStatement;
+    mutex cacheMutex;
     
-    // Decision making variables
-    int currentConnections;
-    double queryTimeout;
-    bool autoCommit;
+    // Calculation variables
+    long long hits;
+    long long misses;
+    long long evictions;
+    
+public:
+    StatementCache(sqlite3* handle, size_t maxStatements = 64)
+        : db(handle), capacity(max<size_t>(maxStatements, 1)), hits(0), misses(0), evictions(0) {}
+    
+    ~StatementCache() {
+        clear();
+    }
+    
+    // Returns a statement for exclusive use until release(); nullptr on error. hasTail is set
+    // when the SQL holds more than one statement, which the cache does not handle.
+    sqlite3_stmt* acquire(const string& sql, bool* hasTail = nullptr) {
+        string key = normalizeSql(sql);
+        if (hasTail) *hasTail = false;
+        
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = bySql.find(key);
+        if (it != bySql.end() && !it->second->inUse) {
+            hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            it->second->inUse = true;
+            return it->second->stmt;
+        }
+        misses++;
+        
+        // Service call - prepare the caller's text; the normalized form is only the cache key
+        sqlite3_stmt* stmt = nullptr;
+        const char* tail = nullptr;
+        if (sqlite3_prepare_v2(db, sql.c_str(), static_cast<int>(sql.size()), &stmt, &tail) != SQLITE_OK) {
+            sqlite3_finalize(stmt);
+            return nullptr;
+        }
+        
+        // Decision making - multi-statement SQL must go through sqlite3_exec
+        if (tail && !isTrivia(tail)) {
+            sqlite3_finalize(stmt);
+            if (hasTail) *hasTail = true;
+            return nullptr;
+        }
+        
+        // Decision making - a statement already checked out is shadowed by an uncached copy
+        if (it != bySql.end() || !stmt) {
+            return stmt;
+        }
+        
+        lru.push_front(Entry{key, stmt, true});
+        bySql[key] = lru.begin();
+        byStatement[stmt] = lru.begin();
+        evictIdle();
+        return stmt;
+    }
+    
+    void release(sqlite3_stmt* stmt) {
+        if (!stmt) return;
+        lock_guard<mutex> lock(cacheMutex);
+        
+        auto it = byStatement.find(stmt);
+        if (it == byStatement.end()) {
+            sqlite3_finalize(stmt);
+            return;
+        }
+        
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        it->second->inUse = false;
+        evictIdle();
+    }
+    
+    void clear() {
+        lock_guard<mutex> lock(cacheMutex);
+        
+        // Loop - finalize every cached statement
+        for (auto& entry : lru) {
+            sqlite3_finalize(entry.stmt);
+        }
+        lru.clear();
+        bySql.clear();
+        byStatement.clear();
+    }
+    
+    map<string, double> getStats() {
+        lock_guard<mutex> lock(cacheMutex);
+        map<string, double> stats;
+        stats["statement_cache_hits"] = static_cast<double>(hits);
+        stats["statement_cache_misses"] = static_cast<double>(misses);
+        stats["statement_cache_evictions"] = static_cast<double>(evictions);
+        stats["statement_cache_size"] = static_cast<double>(lru.size());
+        return stats;
+    }
+    
+    static string normalizeSql(const string& sql) {
+        // Loop - collapse whitespace runs outside quoted literals and comments and trim the ends;
+        // a line comment keeps its terminating newline so distinct statements never share a key
+        string normalized;
+        normalized.reserve(sql.size());
+        char quote = 0;
+        bool pendingSpace = false;
+        
+        for (size_t i = 0; i < sql.size(); ++i) {
+            char c = sql[i];
+            if (quote) {
+                normalized += c;
+                if (c == quote) quote = 0;
+            } else if (c == '-' && i + 1 < sql.size() && sql[i + 1] == '-') {
+                if (pendingSpace) normalized += ' ';
+                pendingSpace = false;
+                size_t end = sql.find('\n', i);
+                if (end == string::npos) end = sql.size() - 1;
+                normalized.append(sql, i, end - i + 1);
+                i = end;
+            } else if (c == '/' && i + 1 < sql.size() && sql[i + 1] == '*') {
+                if (pendingSpace) normalized += ' ';
+                pendingSpace = false;
+                size_t end = sql.find("*/", i + 2);
+                end = end == string::npos ? sql.size() - 1 : end + 1;
+                normalized.append(sql, i, end - i + 1);
+                i = end;
+            } else if (isspace(static_cast<unsigned char>(c))) {
+                pendingSpace = !normalized.empty();
+            } else {
+                if (pendingSpace) normalized += ' ';
+                pendingSpace = false;
+                if (c == '\'' || c == '"') quote = c;
+                normalized += c;
+            }
+        }
+        
+        return normalized;
+    }
+    
+private:
+    static bool isTrivia(const char* tail) {
+        // Loop - whitespace and comments after the last statement are not another statement
+        while (*tail) {
+            if (isspace(static_cast<unsigned char>(*tail))) {
+                tail++;
+            } else if (tail[0] == '-' && tail[1] == '-') {
+                const char* end = strchr(tail, '\n');
+                if (!end) return true;
+                tail = end + 1;
+            } else if (tail[0] == '/' && tail[1] == '*') {
+                const char* end = strstr(tail + 2, "*/");
+                if (!end) return true;
+                tail = end + 2;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    void evictIdle() {
+        // Loop - drop least recently used statements that nobody has checked out
+        auto it = lru.end();
+        while (lru.size() > capacity && it != lru.begin()) {
+            --it;
+            if (it->inUse) continue;
+            
+            sqlite3_finalize(it->stmt);
+            bySql.erase(it->sql);
+            byStatement.erase(it->stmt);
+            it = lru.erase(it);
+            evictions++;
+        }
+    }
+};
+
+// Connection pool class - WAL reader connections checked out one thread at a time
+class ConnectionPool {
+public:
+    struct Connection {
+        sqlite3* handle;
+        StatementCache statements;
+        
+        explicit Connection(sqlite3* db) : handle(db), statements(db) {}
+        
+        ~Connection() {
+            statements.clear();
+            sqlite3_close(handle);
+        }
+    };
+    
+    // RAII checkout - returns the connection to the pool when it goes out of scope
+    // An empty lease (get() == nullptr) means no reader could be checked out
+    class Lease {
+    private:
+        ConnectionPool* pool;
+        Connection* connection;
+        thread::id holder;
+        
+    public:
+        Lease() : pool(nullptr), connection(nullptr) {}
+        Lease(ConnectionPool* owner, Connection* conn) : pool(owner), connection(conn), holder(this_thread::get_id()) {}
+        Lease(Lease&& other) : pool(other.pool), connection(other.connection), holder(other.holder) {
+            other.pool = nullptr;
+            other.connection = nullptr;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        
+        ~Lease() {
+            if (pool && connection) {
+                pool->release(connection, holder);
+            }
+        }
+        
+        Connection* operator->() const { return connection; }
+        Connection* get() const { return connection; }
+    };
+    
+private:
+    vector<unique_ptr<Connection>> connections;
+    vector<Connection*> idle;
+    unordered_map<thread::id, int> leasesHeld;
+    mutex poolMutex;
+    condition_variable available;
     
     // Calculation variables
-    long long totalQueries;
-    long long failedQueries;
-    double averageQueryTime;
+    long long checkouts;
+    long long waits;
+    long long failedCheckouts;
+    
+public:
+    ConnectionPool() : checkouts(0), waits(0), failedCheckouts(0) {}
+    
+    ~ConnectionPool() {
+        close();
+    }
+    
+    bool open(const string& dbPath, int readerCount, const vector<string>& pragmas = {}) {
+        lock_guard<mutex> lock(poolMutex);
+        
+        // Loop - open read-only connections; NOMUTEX is safe because a lease is exclusive
+        for (int i = 0; i < readerCount; ++i) {
+            sqlite3* handle = nullptr;
+            int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+            if (sqlite3_open_v2(dbPath.c_str(), &handle, flags, nullptr) != SQLITE_OK) {
+                cerr << "Failed to open reader connection: " << sqlite3_errmsg(handle) << endl;
+                sqlite3_close(handle);
+                return false;
+            }
+            sqlite3_busy_timeout(handle, 5000);
+            
+            // Decision making - readers only run beside the writer when the database is in WAL mode
+            string journalMode = queryJournalMode(handle);
+            if (journalMode != "wal") {
+                cerr << "Reader pool requires WAL journal mode, database uses: " << journalMode << endl;
+                sqlite3_close(handle);
+                return false;
+            }
+            
+            // Loop - per-connection settings such as cache_size and mmap_size from the active profile
+            for (const auto& pragma : pragmas) {
+                sqlite3_exec(handle, pragma.c_str(), nullptr, nullptr, nullptr);
+            }
+            
+            connections.push_back(unique_ptr<Connection>(new Connection(handle)));
+            idle.push_back(connections.back().get());
+        }
+        return true;
+    }
+    
+    void close() {
+        // All leases must have been returned before the pool is closed
+        lock_guard<mutex> lock(poolMutex);
+        idle.clear();
+        connections.clear();
+    }
+    
+    bool isOpen() {
+        lock_guard<mutex> lock(poolMutex);
+        return !connections.empty();
+    }
+    
+    Lease acquire(chrono::milliseconds timeout = chrono::milliseconds(5000)) {
+        unique_lock<mutex> lock(poolMutex);
+        thread::id self = this_thread::get_id();
+        
+        if (idle.empty()) {
+            // Decision making - a thread that already holds a lease would wait on itself
+            auto held = leasesHeld.find(self);
+            if (held != leasesHeld.end() && held->second > 0) {
+                failedCheckouts++;
+                cerr << "Reader pool exhausted by nested cursors on the calling thread" << endl;
+                return Lease();
+            }
+            
+            // Decision making - block until a reader is free, bounded by the timeout
+            waits++;
+            if (!available.wait_for(lock, timeout, [this]() { return !idle.empty(); })) {
+                failedCheckouts++;
+                cerr << "Timed out waiting for a reader connection" << endl;
+                return Lease();
+            }
+        }
+        
+        Connection* connection = idle.back();
+        idle.pop_back();
+        leasesHeld[self]++;
+        checkouts++;
+        return Lease(this, connection);
+    }
+    
+    map<string, double> getStats() {
+        lock_guard<mutex> lock(poolMutex);
+        map<string, double> stats;
+        stats["pool_readers"] = static_cast<double>(connections.size());
+        stats["pool_idle"] = static_cast<double>(idle.size());
+        stats["pool_checkouts"] = static_cast<double>(checkouts);
+        stats["pool_waits"] = static_cast<double>(waits);
+        stats["pool_failed_checkouts"] = static_cast<double>(failedCheckouts);
+        
+        // Loop - sum statement cache counters across reader connections
+        for (auto& connection : connections) {
+            for (const auto& stat : connection->statements.getStats()) {
+                stats["pool_" + stat.first] += stat.second;
+            }
+        }
+        return stats;
+    }
+    
+private:
+    static string queryJournalMode(sqlite3* handle) {
+        string mode;
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(handle, "PRAGMA journal_mode", -1, &stmt, nullptr) == SQLITE_OK &&
+            sqlite3_step(stmt) == SQLITE_ROW) {
+            const unsigned char* text = sqlite3_column_text(stmt, 0);
+            if (text) mode = reinterpret_cast<const char*>(text);
+        }
+        sqlite3_finalize(stmt);
+        transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        return mode.empty() ? "unknown" : mode;
+    }
+    
+    void release(Connection* connection, thread::id holder) {
+        {
+            lock_guard<mutex> lock(poolMutex);
+            idle.push_back(connection);
+            auto held = leasesHeld.find(holder);
+            if (held != leasesHeld.end() && --held->second == 0) {
+                leasesHeld.erase(held);
+            }
+        }
+        available.notify_one();
+    }
+};
+
+// Row cursor class - steps a statement one row at a time with typed, index-addressed accessors
+class RowCursor {
+private:
+    sqlite3_stmt* stmt;
+    StatementCache* cache;
+    unique_ptr<ConnectionPool::Lease> lease;
+    function<void(sqlite3_stmt*, bool, long long)> onClose;
+    int lastResult;
+    long long rowsReturned;
+    
+public:
+    RowCursor(sqlite3_stmt* statement, StatementCache* owner, unique_ptr<ConnectionPool::Lease> pooled,
+              function<void(sqlite3_stmt*, bool, long long)> closed)
+        : stmt(statement), cache(owner), lease(move(pooled)), onClose(move(closed)),
+          lastResult(statement ? SQLITE_OK : SQLITE_ERROR), rowsReturned(0) {}
+    
+    RowCursor(RowCursor&& other)
+        : stmt(other.stmt), cache(other.cache), lease(move(other.lease)),
+          onClose(move(other.onClose)), lastResult(other.lastResult), rowsReturned(other.rowsReturned) {
+        other.stmt = nullptr;
+        other.onClose = nullptr;
+    }
+    RowCursor(const RowCursor&) = delete;
+    RowCursor& operator=(const RowCursor&) = delete;
+    
+    ~RowCursor() {
+        close();
+    }
+    
+    bool next() {
+        if (!stmt || (lastResult != SQLITE_OK && lastResult != SQLITE_ROW)) return false;
+        lastResult = sqlite3_step(stmt);
+        if (lastResult != SQLITE_ROW) return false;
+        rowsReturned++;
+        return true;
+    }
+    
+    // True when the cursor was valid and every step so far succeeded
+    bool ok() const {
+        return stmt != nullptr && (lastResult == SQLITE_OK || lastResult == SQLITE_ROW || lastResult == SQLITE_DONE);
+    }
+    
+    int columnCount() const {
+        return stmt ? sqlite3_column_count(stmt) : 0;
+    }
+    
+    const char* columnName(int index) const {
+        return sqlite3_column_name(stmt, index);
+    }
+    
+    bool isNull(int index) const {
+        return sqlite3_column_type(stmt, index) == SQLITE_NULL;
+    }
+    
+    int64_t getInt64(int index) const {
+        return sqlite3_column_int64(stmt, index);
+    }
+    
+    double getDouble(int index) const {
+        return sqlite3_column_double(stmt, index);
+    }
+    
+    // The view points into SQLite's buffer and is only valid until the next call to next()
+    string_view getText(int index) const {
+        const unsigned char* text = sqlite3_column_text(stmt, index);
+        if (!text) return string_view();
+        return string_view(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt, index));
+    }
+    
+    void close() {
+        if (!stmt) return;
+        bool success = ok();
+        
+        // Report while the statement still carries its execution counters
+        if (onClose) {
+            onClose(stmt, success, rowsReturned);
+            onClose = nullptr;
+        }
+        
+        // Return the statement to its cache before the pooled connection goes back to the pool
+        cache->release(stmt);
+        stmt = nullptr;
+        lease.reset();
+    }
+};
+
+// Query profile - plan and cumulative execution counters for one SQL fingerprint
+struct QueryProfile {
+    string sql;                   // first statement seen with this fingerprint
+    string fingerprint;
+    string plan;
+    long long executions = 0;
+    long long failures = 0;
+    double totalTime = 0.0;
+    double maxTime = 0.0;
+    long long fullScanSteps = 0;
+    long long sorts = 0;
+    long long autoIndexes = 0;
+    long long vmSteps = 0;
+    bool fullTableScan = false;
+    bool missingIndex = false;
+    bool tempSort = false;
+};
+
+// Slow query log entry
+struct SlowQuery {
+    string sql;
+    string plan;
+    double seconds;
+    long long fullScanSteps;
+    long long vmSteps;
+    chrono::system_clock::time_point when;
+};
+
+// Latency histogram - power-of-two microsecond buckets
+struct LatencyHistogram {
+    static const int bucketCount = 32;
+    array<long long, bucketCount> buckets{};
+    long long count = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+    
+    void add(double seconds) {
+        // Calculation - bucket i holds latencies below 2^i microseconds
+        long long micros = static_cast<long long>(seconds * 1e6);
+        int bucket = 0;
+        while (bucket < bucketCount - 1 && (1LL << bucket) <= micros) {
+            bucket++;
+        }
+        buckets[bucket]++;
+        count++;
+        totalSeconds += seconds;
+        maxSeconds = max(maxSeconds, seconds);
+    }
+    
+    double percentile(double fraction) const {
+        if (count == 0) return 0.0;
+        
+        // Loop - upper bound of the bucket containing the requested rank
+        long long rank = static_cast<long long>(ceil(fraction * count));
+        long long seen = 0;
+        for (int i = 0; i < bucketCount; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return min(maxSeconds, (1LL << i) / 1e6);
+            }
+        }
+        return maxSeconds;
+    }
+};
+
+// Fingerprint statistics - latency and row counts for all SQL sharing a literal-free shape
+struct FingerprintStats {
+    string fingerprint;
+    LatencyHistogram latency;
+    long long rowsReturned = 0;
+    long long rowsAffected = 0;
+    long long failures = 0;
+};
+
+// Query profiler class - EXPLAIN QUERY PLAN plus sqlite3_stmt_status counters per statement
+class QueryProfiler {
+private:
+    mutex profilerMutex;
+    unordered_map<string, QueryProfile> profiles;      // by fingerprint, so literals cannot grow it
+    unordered_map<string, FingerprintStats> fingerprints;
+    unordered_map<string, string> fingerprintBySql;    // memoized fingerprints, cleared when full
+    deque<SlowQuery> slowLog;
+    vector<SlowQuery> slowest; // min-heap on seconds holding the N slowest executions seen so far
+    double slowThreshold;
+    size_t slowLogCapacity;
+    
+    static const size_t fingerprintMemoCapacity = 4096;
+    
+    static bool fasterThan(const SlowQuery& a, const SlowQuery& b) {
+        return a.seconds > b.seconds;
+    }
+    
+public:
+    QueryProfiler(double slowQuerySeconds, size_t maxSlowEntries)
+        : slowThreshold(slowQuerySeconds), slowLogCapacity(max<size_t>(maxSlowEntries, 1)) {}
+    
+    void record(sqlite3_stmt* stmt, double seconds, bool success, long long rowsReturned, long long rowsAffected) {
+        if (!stmt) return;
+        
+        // Calculation - per-execution counters; the reset flag clears them for the next run
+        long long fullScanSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+        long long sorts = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+        long long autoIndexes = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_AUTOINDEX, 1);
+        long long vmSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+        
+        const char* text = sqlite3_sql(stmt);
+        string sql = text ? text : "";
+        
+        unique_lock<mutex> lock(profilerMutex);
+        string fingerprint = fingerprintFor(sql);
+        auto it = profiles.find(fingerprint);
+        if (it == profiles.end()) {
+            // Decision making - plans are captured once per fingerprint, with EXPLAIN run
+            // outside the lock so other threads keep recording meanwhile
+            lock.unlock();
+            QueryProfile profile;
+            profile.sql = sql;
+            profile.fingerprint = fingerprint;
+            profile.plan = explainPlan(sqlite3_db_handle(stmt), sql);
+            classifyPlan(profile);
+            lock.lock();
+            it = profiles.emplace(fingerprint, move(profile)).first;
+        }
+        
+        QueryProfile& profile = it->second;
+        profile.executions++;
+        if (!success) profile.failures++;
+        profile.totalTime += seconds;
+        profile.maxTime = max(profile.maxTime, seconds);
+        profile.fullScanSteps += fullScanSteps;
+        profile.sorts += sorts;
+        profile.autoIndexes += autoIndexes;
+        profile.vmSteps += vmSteps;
+        
+        // Decision making - runtime counters confirm what the plan predicted
+        if (autoIndexes > 0) profile.missingIndex = true;
+        
+        // Calculation - per-fingerprint histogram and row counters
+        FingerprintStats& stats = fingerprints[profile.fingerprint];
+        if (stats.fingerprint.empty()) stats.fingerprint = profile.fingerprint;
+        stats.latency.add(seconds);
+        stats.rowsReturned += rowsReturned;
+        stats.rowsAffected += rowsAffected;
+        if (!success) stats.failures++;
+        
+        SlowQuery entry{sql, profile.plan, seconds, fullScanSteps, vmSteps, chrono::system_clock::now()};
+        
+        if (seconds >= slowThreshold) {
+            slowLog.push_back(entry);
+            if (slowLog.size() > slowLogCapacity) {
+                slowLog.pop_front();
+            }
+        }
+        
+        // Decision making - keep the N slowest; the heap front is the fastest of them
+        if (slowest.size() < slowLogCapacity) {
+            slowest.push_back(move(entry));
+            push_heap(slowest.begin(), slowest.end(), fasterThan);
+        } else if (slowest.front().seconds < seconds) {
+            pop_heap(slowest.begin(), slowest.end(), fasterThan);
+            slowest.back() = move(entry);
+            push_heap(slowest.begin(), slowest.end(), fasterThan);
+        }
+    }
+    
+    vector<FingerprintStats> getFingerprintStats() {
+        lock_guard<mutex> lock(profilerMutex);
+        vector<FingerprintStats> result;
+        for (const auto& entry : fingerprints) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+    
+    vector<SlowQuery> getSlowestQueries() {
+        lock_guard<mutex> lock(profilerMutex);
+        vector<SlowQuery> result = slowest;
+        sort(result.begin(), result.end(), [](const SlowQuery& a, const SlowQuery& b) { return a.seconds > b.seconds; });
+        return result;
+    }
+    
+    string dumpJson() {
+        vector<FingerprintStats> stats = getFingerprintStats();
+        vector<SlowQuery> slowQueries = getSlowestQueries();
+        
+        stringstream ss;
+        ss << setprecision(9);
+        ss << "{\n  \"fingerprints\": [\n";
+        for (size_t i = 0; i < stats.size(); ++i) {
+            const auto& f = stats[i];
+            ss << "    {\"fingerprint\": \"" << jsonEscape(f.fingerprint) << "\""
+               << ", \"count\": " << f.latency.count
+               << ", \"failures\": " << f.failures
+               << ", \"mean_seconds\": " << (f.latency.count ? f.latency.totalSeconds / f.latency.count : 0.0)
+               << ", \"p50_seconds\": " << f.latency.percentile(0.50)
+               << ", \"p99_seconds\": " << f.latency.percentile(0.99)
+               << ", \"max_seconds\": " << f.latency.maxSeconds
+               << ", \"rows_returned\": " << f.rowsReturned
+               << ", \"rows_affected\": " << f.rowsAffected
+               << ", \"histogram_us_upper_bounds\": {";
+            bool first = true;
+            for (int b = 0; b < LatencyHistogram::bucketCount; ++b) {
+                if (f.latency.buckets[b] == 0) continue;
+                ss << (first ? "" : ", ") << "\"" << (1LL << b) << "\": " << f.latency.buckets[b];
+                first = false;
+            }
+            ss << "}}" << (i + 1 < stats.size() ? "," : "") << "\n";
+        }
+        ss << "  ],\n  \"slowest\": [\n";
+        for (size_t i = 0; i < slowQueries.size(); ++i) {
+            const auto& q = slowQueries[i];
+            ss << "    {\"sql\": \"" << jsonEscape(q.sql) << "\""
+               << ", \"seconds\": " << q.seconds
+               << ", \"plan\": \"" << jsonEscape(q.plan) << "\""
+               << ", \"full_scan_steps\": " << q.fullScanSteps
+               << ", \"vm_steps\": " << q.vmSteps << "}"
+               << (i + 1 < slowQueries.size() ? "," : "") << "\n";
+        }
+        ss << "  ]\n}\n";
+        return ss.str();
+    }
+    
+    static string fingerprintSql(const string& sql) {
+        // Loop - replace string and numeric literals with ? so similar queries share statistics
+        string fingerprint;
+        fingerprint.reserve(sql.size());
+        
+        for (size_t i = 0; i < sql.size(); ++i) {
+            char c = sql[i];
+            bool identifierBefore = !fingerprint.empty() &&
+                (isalnum(static_cast<unsigned char>(fingerprint.back())) || fingerprint.back() == '_');
+            
+            if (c == '\'') {
+                // Skip the literal, honouring '' escapes
+                size_t j = i + 1;
+                while (j < sql.size() && !(sql[j] == '\'' && (j + 1 >= sql.size() || sql[j + 1] != '\''))) {
+                    j += (sql[j] == '\'') ? 2 : 1;
+                }
+                fingerprint += '?';
+                i = j;
+            } else if (isdigit(static_cast<unsigned char>(c)) && !identifierBefore) {
+                while (i + 1 < sql.size() && (isdigit(static_cast<unsigned char>(sql[i + 1])) || sql[i + 1] == '.')) {
+                    i++;
+                }
+                fingerprint += '?';
+            } else {
+                fingerprint += c;
+            }
+        }
+        
+        return fingerprint;
+    }
+    
+    static string jsonEscape(const string& text) {
+        string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (c == '\n') {
+                escaped += "\\n";
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += ' ';
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+    
+    bool findProfile(const string& sql, QueryProfile& out) {
+        lock_guard<mutex> lock(profilerMutex);
+        auto it = profiles.find(fingerprintFor(sql));
+        if (it == profiles.end()) return false;
+        out = it->second;
+        return true;
+    }
+    
+    vector<QueryProfile> getProfiles() {
+        lock_guard<mutex> lock(profilerMutex);
+        vector<QueryProfile> result;
+        for (const auto& entry : profiles) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+    
+    vector<SlowQuery> getSlowQueries() {
+        lock_guard<mutex> lock(profilerMutex);
+        return vector<SlowQuery>(slowLog.begin(), slowLog.end());
+    }
+    
+    void setSlowThreshold(double seconds) {
+        lock_guard<mutex> lock(profilerMutex);
+        slowThreshold = seconds;
+    }
+    
+    static string explainPlan(sqlite3* db, const string& sql) {
+        // Decision making - only data statements have a meaningful query plan
+        string keyword;
+        for (char c : sql) {
+            if (isalpha(static_cast<unsigned char>(c))) keyword += static_cast<char>(toupper(c));
+            else if (!keyword.empty()) break;
+        }
+        if (keyword != "SELECT" && keyword != "INSERT" && keyword != "UPDATE" &&
+            keyword != "DELETE" && keyword != "WITH" && keyword != "REPLACE") {
+            return "";
+        }
+        
+        sqlite3_stmt* explain = nullptr;
+        string explainSQL = "EXPLAIN QUERY PLAN " + sql;
+        if (sqlite3_prepare_v2(db, explainSQL.c_str(), -1, &explain, nullptr) != SQLITE_OK) {
+            sqlite3_finalize(explain);
+            return "";
+        }
+        
+        // Loop - the detail column (index 3) holds lines like "SCAN data_records"
+        string plan;
+        while (sqlite3_step(explain) == SQLITE_ROW) {
+            const unsigned char* detail = sqlite3_column_text(explain, 3);
+            if (!detail) continue;
+            if (!plan.empty()) plan += "; ";
+            plan += reinterpret_cast<const char*>(detail);
+        }
+        sqlite3_finalize(explain);
+        return plan;
+    }
+    
+    string fingerprintFor(const string& sql) {
+        // Calculation - whitespace-insensitive, literal-free shape; memoized under profilerMutex
+        auto it = fingerprintBySql.find(sql);
+        if (it != fingerprintBySql.end()) return it->second;
+        
+        if (fingerprintBySql.size() >= fingerprintMemoCapacity) {
+            fingerprintBySql.clear();
+        }
+        string fingerprint = fingerprintSql(StatementCache::normalizeSql(sql));
+        fingerprintBySql.emplace(sql, fingerprint);
+        return fingerprint;
+    }
+    
+    static void classifyPlan(QueryProfile& profile) {
+        const string& plan = profile.plan;
+        size_t pos = 0;
+        bool tableScan = false;
+        
+        // Loop - a SCAN step visits every row, even when it walks an index in order
+        while ((pos = plan.find("SCAN ", pos)) != string::npos) {
+            if (plan.compare(pos, 17, "SCAN CONSTANT ROW") != 0) {
+                profile.fullTableScan = true;
+                
+                // Decision making - subquery and CTE scans read materialized rows, not a table
+                if (plan.compare(pos, 6, "SCAN (") != 0 && plan.compare(pos, 14, "SCAN SUBQUERY ") != 0) {
+                    tableScan = true;
+                }
+            }
+            pos += 5;
+        }
+        
+        // Decision making - a filtered table scan is a missing index as much as an automatic one
+        string upperSql = profile.sql;
+        transform(upperSql.begin(), upperSql.end(), upperSql.begin(), ::toupper);
+        bool filtered = hasKeyword(upperSql, "WHERE") || hasKeyword(upperSql, "ON");
+        
+        profile.missingIndex = plan.find("AUTOMATIC") != string::npos || (tableScan && filtered);
+        profile.tempSort = plan.find("TEMP B-TREE") != string::npos;
+    }
+    
+    static bool hasKeyword(const string& upperSql, const string& keyword) {
+        // Loop - whole-word match so column names such as "region" or "nowhere" do not count
+        size_t pos = 0;
+        while ((pos = upperSql.find(keyword, pos)) != string::npos) {
+            size_t end = pos + keyword.size();
+            bool startsWord = pos == 0 || !(isalnum(static_cast<unsigned char>(upperSql[pos - 1])) || upperSql[pos - 1] == '_');
+            bool endsWord = end == upperSql.size() || !(isalnum(static_cast<unsigned char>(upperSql[end])) || upperSql[end] == '_');
+            if (startsWord && endsWord) return true;
+            pos = end;
+        }
+        return false;
+    }
+};
+
+// Query result cache class - read-through cache of materialized results with table-level invalidation
+class QueryResultCache {
+public:
+    typedef vector<map<string, string>> Rows;
+    
+private:
+    struct Entry {
+        string key;
+        shared_ptr<const Rows> rows;
+        set<string> tables;
+        size_t bytes;
+        chrono::steady_clock::time_point expires;
+    };
+    
+    mutex cacheMutex;
+    list<Entry> lru;
+    unordered_map<string, list<Entry>::iterator> byKey;
+    unordered_map<string, set<string>> keysByTable;
+    unordered_map<string, long long> tableGeneration;
+    size_t memoryBudget;
+    size_t bytesUsed;
+    chrono::milliseconds ttl;
+    
+    // Calculation variables
+    long long hits;
+    long long misses;
+    long long invalidations;
+    long long expirations;
+    
+public:
+    QueryResultCache(size_t memoryBudgetBytes, chrono::milliseconds timeToLive)
+        : memoryBudget(memoryBudgetBytes), bytesUsed(0), ttl(timeToLive),
+          hits(0), misses(0), invalidations(0), expirations(0) {}
+    
+    shared_ptr<const Rows> lookup(const string& key) {
+        lock_guard<mutex> lock(cacheMutex);
+        auto it = byKey.find(key);
+        if (it == byKey.end()) {
+            misses++;
+            return nullptr;
+        }
+        
+        // Decision making - expired entries are dropped on access
+        if (chrono::steady_clock::now() >= it->second->expires) {
+            erase(it->second);
+            expirations++;
+            misses++;
+            return nullptr;
+        }
+        
+        lru.splice(lru.begin(), lru, it->second);
+        hits++;
+        return it->second->rows;
+    }
+    
+    // Snapshot of table generations, taken before the read starts
+    map<string, long long> generations(const set<string>& tables) {
+        lock_guard<mutex> lock(cacheMutex);
+        map<string, long long> snapshot;
+        for (const auto& table : tables) {
+            snapshot[table] = tableGeneration[table];
+        }
+        return snapshot;
+    }
+    
+    void insert(const string& key, Rows rows, const set<string>& tables, const map<string, long long>& readGenerations) {
+        // Calculation - approximate memory held by the materialized rows
+        size_t bytes = sizeof(Entry) + key.size();
+        for (const auto& row : rows) {
+            bytes += sizeof(row);
+            for (const auto& column : row) {
+                bytes += column.first.capacity() + column.second.capacity() + 4 * sizeof(void*);
+            }
+        }
+        if (bytes > memoryBudget) return;
+        
+        lock_guard<mutex> lock(cacheMutex);
+        
+        // Decision making - a write committed during the read makes this result stale
+        for (const auto& generation : readGenerations) {
+            if (tableGeneration[generation.first] != generation.second) return;
+        }
+        
+        auto existing = byKey.find(key);
+        if (existing != byKey.end()) {
+            erase(existing->second);
+        }
+        
+        lru.push_front(Entry{key, make_shared<const Rows>(move(rows)), tables, bytes, chrono::steady_clock::now() + ttl});
+        byKey[key] = lru.begin();
+        for (const auto& table : tables) {
+            keysByTable[table].insert(key);
+        }
+        bytesUsed += bytes;
+        
+        // Loop - evict least recently used entries until within budget
+        while (bytesUsed > memoryBudget && !lru.empty()) {
+            erase(prev(lru.end()));
+        }
+    }
+    
+    void invalidateTable(const string& table) {
+        lock_guard<mutex> lock(cacheMutex);
+        tableGeneration[table]++;
+        
+        auto it = keysByTable.find(table);
+        if (it == keysByTable.end()) return;
+        
+        // Loop - drop every entry that read from this table
+        set<string> keys = it->second;
+        for (const auto& key : keys) {
+            auto entry = byKey.find(key);
+            if (entry != byKey.end()) {
+                erase(entry->second);
+                invalidations++;
+            }
+        }
+    }
+    
+    void invalidateAll() {
+        lock_guard<mutex> lock(cacheMutex);
+        for (auto& generation : tableGeneration) {
+            generation.second++;
+        }
+        invalidations += static_cast<long long>(lru.size());
+        lru.clear();
+        byKey.clear();
+        keysByTable.clear();
+        bytesUsed = 0;
+    }
+    
+    map<string, double> getStats() {
+        lock_guard<mutex> lock(cacheMutex);
+        map<string, double> stats;
+        long long lookups = hits + misses;
+        stats["result_cache_hits"] = static_cast<double>(hits);
+        stats["result_cache_misses"] = static_cast<double>(misses);
+        stats["result_cache_hit_rate"] = lookups > 0 ? static_cast<double>(hits) / lookups : 0.0;
+        stats["result_cache_invalidations"] = static_cast<double>(invalidations);
+        stats["result_cache_expirations"] = static_cast<double>(expirations);
+        stats["result_cache_entries"] = static_cast<double>(lru.size());
+        stats["result_cache_bytes"] = static_cast<double>(bytesUsed);
+        return stats;
+    }
+    
+    static string makeKey(const string& sql, const vector<string>& params) {
+        // Length-prefixed parameters keep distinct parameter lists from colliding
+        string key = StatementCache::normalizeSql(sql);
+        for (const auto& param : params) {
+            key += '\x1f';
+            key += to_string(param.size());
+            key += ':';
+            key += param;
+        }
+        return key;
+    }
+    
+private:
+    void erase(list<Entry>::iterator entry) {
+        for (const auto& table : entry->tables) {
+            auto keys = keysByTable.find(table);
+            if (keys == keysByTable.end()) continue;
+            keys->second.erase(entry->key);
+            if (keys->second.empty()) keysByTable.erase(keys);
+        }
+        bytesUsed -= entry->bytes;
+        byKey.erase(entry->key);
+        lru.erase(entry);
+    }
+};
+
+// Write request for the asynchronous writer - one parameterized statement and its acknowledgement
+struct WriteRequest {
+    string sql;
+    vector<string> params;
+    promise<bool> durable;
+    atomic<WriteRequest*> next;
+    
+    WriteRequest() : next(nullptr) {}
+    WriteRequest(const string& statement, vector<string> values)
+        : sql(statement), params(move(values)), next(nullptr) {}
+};
+
+// Write queue class - lock-free multi-producer, single-consumer intrusive queue of write requests
+class WriteQueue {
+private:
+    atomic<WriteRequest*> head; // producers append here
+    WriteRequest* tail;         // consumer pops from here
+    WriteRequest stub;
+    
+public:
+    WriteQueue() : head(&stub), tail(&stub) {}
+    
+    ~WriteQueue() {
+        // Loop - fail anything never drained
+        while (WriteRequest* request = pop()) {
+            request->durable.set_value(false);
+            delete request;
+        }
+    }
+    
+    void push(WriteRequest* request) {
+        request->next.store(nullptr, memory_order_relaxed);
+        WriteRequest* previous = head.exchange(request, memory_order_acq_rel);
+        previous->next.store(request, memory_order_release);
+    }
+    
+    // Consumer only; returns nullptr when empty or when a producer is mid-push
+    WriteRequest* pop() {
+        WriteRequest* current = tail;
+        WriteRequest* next = current->next.load(memory_order_acquire);
+        
+        // Decision making - skip over the stub node
+        if (current == &stub) {
+            if (!next) return nullptr;
+            tail = next;
+            current = next;
+            next = next->next.load(memory_order_acquire);
+        }
+        
+        if (next) {
+            tail = next;
+            return current;
+        }
+        
+        // Decision making - the last real node can only be taken once the stub is re-linked behind it
+        if (current != head.load(memory_order_acquire)) return nullptr;
+        push(&stub);
+        next = current->next.load(memory_order_acquire);
+        if (next) {
+            tail = next;
+            return current;
+        }
+        return nullptr;
+    }
+    
+    bool empty() {
+        return tail == &stub ? stub.next.load(memory_order_acquire) == nullptr : false;
+    }
+};
+
+// PRAGMA profile - connection tuning for one workload shape
+struct PragmaProfile {
+    string name;
+    int pageSize;                 // bytes; only takes effect before the database has any content
+    long long cacheSizeKb;
+    long long mmapSize;           // bytes
+    int tempStore;                // 0 default, 1 file, 2 memory
+    int walAutocheckpoint;        // WAL frames between automatic checkpoints
+    int busyTimeoutMs;
+    
+    static vector<PragmaProfile> builtins() {
+        return {
+            // Large pages and cache, rare checkpoints: fewest syscalls per inserted row
+            {"bulk-load", 8192, 262144, 268435456, 2, 10000, 10000},
+            // Moderate cache, default checkpoint cadence keeps commit latency flat
+            {"oltp", 4096, 65536, 67108864, 2, 1000, 5000},
+            // Wide mmap window and short WAL so readers rarely consult it
+            {"read-mostly", 4096, 131072, 1073741824, 2, 500, 2000}
+        };
+    }
+    
+    static bool find(const string& name, PragmaProfile& profile) {
+        for (const auto& candidate : builtins()) {
+            if (candidate.name == name) {
+                profile = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Settings that every connection, including pooled readers, needs on its own
+    vector<string> connectionPragmas() const {
+        return {"PRAGMA cache_size = -" + to_string(cacheSizeKb),
+                "PRAGMA mmap_size = " + to_string(mmapSize),
+                "PRAGMA temp_store = " + to_string(tempStore),
+                "PRAGMA busy_timeout = " + to_string(busyTimeoutMs)};
+    }
+};
+
+// Profile benchmark result measured on this machine, one sample per run
+struct ProfileBenchmark {
+    string profile;
+    double insertRowsPerSecond;   // mean over runs
+    double selectsPerSecond;      // mean over runs
+    double insertStddev;
+    double selectStddev;
+    vector<double> insertSamples;
+    vector<double> selectSamples;
+};
+
+class DatabaseManager {
+public:
+    sqlite3* db;
+    bool initialized;
+    string databasePath;
+    map<string, sqlite3_stmt*> preparedStatements;
+    PragmaProfile activeProfile;
+    atomic<int> walAutocheckpointFrames;
+    unique_ptr<StatementCache> writerStatements;
+    ConnectionPool readerPool;
+    mutex metricsMutex;
+    recursive_mutex transactionMutex; // executeQuery re-enters it inside explicit transactions
+    
+    // Asynchronous writer
+    WriteQueue writeQueue;
+    thread asyncWriter;
+    atomic<bool> asyncWriterRunning;
+    atomic<int> asyncProducers;        // callers between the running check and the end of their push
+    atomic<bool> asyncWriterIdle;
+    mutex asyncWakeMutex;
+    condition_variable asyncWake;
+    size_t groupCommitSize;
+    chrono::milliseconds groupCommitDelay;
+    atomic<long long> asyncCommits;
+    atomic<long long> asyncWrites;
+    
+    // Query profiling
+    unique_ptr<QueryProfiler> queryProfiler;
+    
+    // Query result caching
+    unique_ptr<QueryResultCache> resultCache;
+    sqlite3* analysisDb;               // connection carrying the table-capturing authorizer
+    set<string> pendingDirtyTables;    // written in the open transaction
+    set<string> committingTables;      // invalidated again once the WAL commit is visible
+    vector<string> tablesChangedInTransaction; // raw names already invalidated; touched only by hooks
+    mutex dirtyTablesMutex;
+    
+    // Read dependencies memoized per normalized SQL so cache hits skip the analysis prepare
+    struct QueryDependencies {
+        bool cacheable;
+        set<string> tables;
+    };
+    unordered_map<string, QueryDependencies> queryDependencies;
+    mutex dependencyMutex;
+    static const size_t queryDependencyCapacity = 4096;
+    
+    // Time partitioning - one data_records_pYYYYMMDD table per day
+    bool partitioningEnabled;
+    set<string> partitionDays;
+    mutex partitionMutex;
+    
+    // Maintenance scheduling
+    thread maintenanceThread;
+    bool maintenanceRunning;
+    mutex maintenanceMutex;
+    condition_variable maintenanceWake;
+    atomic<long long> lastActivity;
+    map<string, double> lastMaintenanceReport;
+    static const int maintenancePagesPerStep = 64;
+    
+    // Background backups - close() cancels and joins them before the writer handle goes away
+    struct BackupTask {
+        thread worker;
+        shared_ptr<atomic<bool>> finished;
+    };
+    list<BackupTask> backupTasks;
+    mutex backupMutex;
+    atomic<bool> backupsCancelled;
+    
+    // Background WAL checkpointing
+    thread checkpointThread;
+    bool checkpointerRunning;
+    mutex checkpointMutex;
+    condition_variable checkpointWake;
+    sqlite3* checkpointDb;             // dedicated handle so checkpoints never hold the writer's mutex
+    atomic<bool> backgroundCheckpointing;
+    atomic<long long> walFrames;
+    atomic<long long> walCommits;
+    long long checkpointPassiveFrames;
+    map<string, double> checkpointStats;
+    
+    // Decision making variables
+    int currentConnections;
+    double queryTimeout;
+    bool autoCommit;
+    
+    // Calculation variables
+    long long totalQueries;
+    long long failedQueries;
+    double averageQueryTime;
+    double lastBatchRowsPerSecond;
+    
+    // Rows bound per execution of the multi-row VALUES insert
+    static const size_t batchInsertRowsPerStatement = 64;
+    
+    // CSV imports at least this fraction of the table's size drop and rebuild secondary indexes
+    static constexpr double bulkImportIndexRebuildRatio = 0.5;
+    
+public:
+    DatabaseManager() : db(nullptr), initialized(false), walAutocheckpointFrames(1000), asyncWriterRunning(false),
+                       asyncProducers(0), asyncWriterIdle(false), groupCommitSize(256), groupCommitDelay(5),
+                       asyncCommits(0), asyncWrites(0), analysisDb(nullptr),
+                       partitioningEnabled(false), maintenanceRunning(false), lastActivity(0), backupsCancelled(false),
+                       checkpointerRunning(false), checkpointDb(nullptr), backgroundCheckpointing(false),
+                       walFrames(0), walCommits(0), checkpointPassiveFrames(1000),
+                       currentConnections(0), 
+                       queryTimeout(30.0), autoCommit(true), totalQueries(0), 
+                       failedQueries(0), averageQueryTime(0.0), lastBatchRowsPerSecond(0.0) {}
+    
+    ~DatabaseManager() {
+        close();
+    }
+    
+    bool initialize(const string& dbPath, const string& profileName = "oltp") {
+        // IO call - open database file (this handle is the single writer connection)
+        databasePath = dbPath;
+        int result = sqlite3_open(dbPath.c_str(), &db);
+        if (result != SQLITE_OK) {
+            cerr << "Failed to open database: " << sqlite3_errmsg(db) << endl;
+            return false;
+        }
+        
+        // Queries below run through executeQuery, which requires an initialized handle
+        writerStatements.reset(new StatementCache(db));
+        initialized = true;
+        
+        // page_size must precede the first table and the switch to WAL
+        if (!applyPragmaProfile(profileName)) {
+            close();
+            return false;
+        }
+        
+        // Incremental auto-vacuum takes effect on new databases; existing ones need convertToIncrementalVacuum
+        executeQuery("PRAGMA auto_vacuum=INCREMENTAL");
+        
+        // Decision making - enable WAL mode for better performance
+        if (shouldEnableWAL("initialize")) {
+            executeQuery("PRAGMA journal_mode=WAL");
+            executeQuery("PRAGMA synchronous=NORMAL");
+        }
+        
+        // Create tables, apply migrations and prepare statements
+        if (!createTables() || !migrateSchema() || !prepareStatements()) {
+            close();
+            return false;
+        }
+        
+        cout << "Database initialized successfully" << endl;
+        return true;
+    }
+    
+    bool applyPragmaProfile(const string& profileName) {
+        if (!initialized) return false;
+        
+        PragmaProfile profile;
+        if (!PragmaProfile::find(profileName, profile)) {
+            cerr << "Unknown PRAGMA profile: " << profileName << endl;
+            return false;
+        }
+        
+        // Decision making - page_size is fixed once the file has pages, so only new databases get it
+        if (pragmaValue("PRAGMA page_count") == 0) {
+            executeQuery("PRAGMA page_size = " + to_string(profile.pageSize));
+        }
+        
+        for (const auto& pragma : profile.connectionPragmas()) {
+            if (!executeQuery(pragma)) return false;
+        }
+        
+        // Our WAL hook (result cache or checkpointer) applies the threshold; the pragma would replace it
+        walAutocheckpointFrames = profile.walAutocheckpoint;
+        if (!resultCache && !backgroundCheckpointing && !executeQuery("PRAGMA wal_autocheckpoint = " + to_string(profile.walAutocheckpoint))) {
+            return false;
+        }
+        
+        activeProfile = profile;
+        return true;
+    }
+    
+    // rowCount 0 sizes the table past the smallest profile's page cache so cache_size and mmap_size matter
+    vector<ProfileBenchmark> benchmarkPragmaProfiles(size_t rowCount = 0, int selectCount = 2000, int runs = 3) {
+        vector<ProfileBenchmark> results;
+        string basePath = databasePath.empty() || databasePath == ":memory:" ? "pragma_benchmark" : databasePath;
+        vector<PragmaProfile> profiles = PragmaProfile::builtins();
+        const size_t payloadBytes = 1024;
+        const size_t chunkRows = 10000;
+        
+        if (rowCount == 0) {
+            long long smallestCacheKb = profiles.front().cacheSizeKb;
+            for (const auto& profile : profiles) {
+                smallestCacheKb = min(smallestCacheKb, profile.cacheSizeKb);
+            }
+            rowCount = static_cast<size_t>(smallestCacheKb * 1024 / payloadBytes) * 3 / 2;
+        }
+        
+        // One chunk of rows is inserted repeatedly to keep the generator's own footprint small
+        vector<vector<string>> rows;
+        rows.reserve(min(rowCount, chunkRows));
+        for (size_t i = 0; i < min(rowCount, chunkRows); ++i) {
+            rows.push_back({"Bench" + to_string(i % 1000), string(payloadBytes, 'x'), "2024-01-01 00:00:00"});
+        }
+        
+        for (const auto& profile : profiles) {
+            results.push_back({profile.name, 0.0, 0.0, 0.0, 0.0, {}, {}});
+        }
+        
+        // Loop - runs interleave the profiles so machine drift spreads over all of them
+        for (int run = 0; run < runs; ++run) {
+            for (size_t p = 0; p < profiles.size(); ++p) {
+                const PragmaProfile& profile = profiles[p];
+                string path = basePath + ".bench-" + profile.name;
+                for (const char* suffix : {"", "-wal", "-shm"}) {
+                    remove((path + suffix).c_str());
+                }
+                
+                {
+                    DatabaseManager scratch;
+                    if (!scratch.initialize(path, profile.name)) continue;
+                    
+                    bool inserted = true;
+                    auto insertStart = chrono::high_resolution_clock::now();
+                    for (size_t written = 0; inserted && written < rowCount; written += rows.size()) {
+                        inserted = scratch.batchInsert(rows);
+                    }
+                    auto insertEnd = chrono::high_resolution_clock::now();
+                    double insertSeconds = chrono::duration<double>(insertEnd - insertStart).count();
+                    
+                    // Point lookups spread across the whole table plus a short range scan
+                    size_t tableRows = (rowCount + rows.size() - 1) / rows.size() * rows.size();
+                    auto selectStart = chrono::high_resolution_clock::now();
+                    for (int i = 0; i < selectCount; ++i) {
+                        string id = to_string(1 + (static_cast<size_t>(i) * 7919) % tableRows);
+                        scratch.selectQuery("SELECT * FROM data_records WHERE id = ?", {id});
+                        if (i % 100 == 0) {
+                            scratch.selectQuery("SELECT COUNT(*) FROM data_records WHERE name = ?", {"Bench" + to_string(i % 1000)});
+                        }
+                    }
+                    auto selectEnd = chrono::high_resolution_clock::now();
+                    double selectSeconds = chrono::duration<double>(selectEnd - selectStart).count();
+                    
+                    if (inserted && insertSeconds > 0.0 && selectSeconds > 0.0) {
+                        results[p].insertSamples.push_back(tableRows / insertSeconds);
+                        results[p].selectSamples.push_back(selectCount / selectSeconds);
+                    }
+                }
+                
+                for (const char* suffix : {"", "-wal", "-shm"}) {
+                    remove((path + suffix).c_str());
+                }
+            }
+        }
+        
+        for (auto& result : results) {
+            meanAndStddev(result.insertSamples, result.insertRowsPerSecond, result.insertStddev);
+            meanAndStddev(result.selectSamples, result.selectsPerSecond, result.selectStddev);
+        }
+        return results;
+    }
+    
+    // Returns an empty name when the best profile is not ahead of the runner-up by more than the run-to-run noise
+    string recommendPragmaProfile(const vector<ProfileBenchmark>& results, double readFraction) {
+        struct Candidate { string profile; double cost; double stddev; };
+        vector<Candidate> candidates;
+        
+        // Calculation - expected seconds per operation for the given read/write mix, per run
+        for (const auto& result : results) {
+            vector<double> costs;
+            for (size_t i = 0; i < result.insertSamples.size() && i < result.selectSamples.size(); ++i) {
+                costs.push_back((1.0 - readFraction) / result.insertSamples[i] + readFraction / result.selectSamples[i]);
+            }
+            if (costs.empty()) continue;
+            Candidate candidate{result.profile, 0.0, 0.0};
+            meanAndStddev(costs, candidate.cost, candidate.stddev);
+            candidates.push_back(candidate);
+        }
+        if (candidates.empty()) return "";
+        
+        sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.cost < b.cost; });
+        if (candidates.size() == 1) return candidates[0].profile;
+        
+        // Decision making - the gap must exceed the combined standard deviation of both costs
+        double gap = candidates[1].cost - candidates[0].cost;
+        double noise = sqrt(candidates[0].stddev * candidates[0].stddev + candidates[1].stddev * candidates[1].stddev);
+        return gap > noise ? candidates[0].profile : "";
+    }
+    
+    bool enableConnectionPool(int readerCount) {
+        if (!initialized || readerCount <= 0) return false;
+        
+        // Decision making - readers need a shared on-disk database in WAL mode
+        if (databasePath.empty() || databasePath == ":memory:") {
+            cerr << "Connection pool requires an on-disk database" << endl;
+            return false;
+        }
+        
+        if (!readerPool.open(databasePath, readerCount, activeProfile.connectionPragmas())) {
+            readerPool.close();
+            return false;
+        }
+        return true;
+    }
+    
+    bool startAsyncWriter(size_t maxGroupSize, chrono::milliseconds maxGroupDelay) {
+        if (!initialized || asyncWriterRunning) return false;
+        
+        groupCommitSize = max<size_t>(maxGroupSize, 1);
+        groupCommitDelay = maxGroupDelay;
+        asyncWriterRunning = true;
+        asyncWriter = thread(&DatabaseManager::runAsyncWriter, this);
+        return true;
+    }
+    
+    void stopAsyncWriter() {
+        if (!asyncWriterRunning.exchange(false)) return;
+        wakeAsyncWriter();
+        asyncWriter.join();
+        
+        // Producers that passed the running check finish their push before the final drain
+        while (asyncProducers.load() > 0) {
+            this_thread::yield();
+        }
+        
+        // Loop - fail anything the writer did not pick up
+        while (WriteRequest* request = writeQueue.pop()) {
+            request->durable.set_value(false);
+            delete request;
+        }
+    }
+    
+    // The future resolves true once the request is committed with synchronous=FULL
+    future<bool> asyncExecute(const string& sql, vector<string> params) {
+        WriteRequest* request = new WriteRequest(sql, move(params));
+        future<bool> durable = request->durable.get_future();
+        
+        // Decision making - register before re-checking the flag, so stopAsyncWriter either waits for
+        // this push or this caller sees the writer stopped; the queue itself stays lock-free
+        asyncProducers.fetch_add(1);
+        if (!asyncWriterRunning.load()) {
+            asyncProducers.fetch_sub(1);
+            request->durable.set_value(false);
+            delete request;
+            return durable;
+        }
+        writeQueue.push(request);
+        asyncProducers.fetch_sub(1);
+        
+        // Only wake the writer when it is parked
+        if (asyncWriterIdle.load(memory_order_acquire)) {
+            wakeAsyncWriter();
+        }
+        return durable;
+    }
+    
+    future<bool> asyncInsert(const string& name, const string& value, const string& timestamp) {
+        return asyncExecute("INSERT INTO data_records (name, value, timestamp) VALUES (?, ?, ?)",
+                            {name, value, timestamp});
+    }
+    
+    void enableQueryProfiling(double slowQuerySeconds, size_t maxSlowEntries = 100) {
+        // Decision making - enable before issuing queries; profiling stays on until close
+        queryProfiler.reset(new QueryProfiler(slowQuerySeconds, maxSlowEntries));
+    }
+    
+    vector<QueryProfile> getQueryProfiles() {
+        return queryProfiler ? queryProfiler->getProfiles() : vector<QueryProfile>();
+    }
+    
+    vector<SlowQuery> getSlowQueries() {
+        return queryProfiler ? queryProfiler->getSlowQueries() : vector<SlowQuery>();
+    }
+    
+    vector<FingerprintStats> getQueryLatencyStats() {
+        return queryProfiler ? queryProfiler->getFingerprintStats() : vector<FingerprintStats>();
+    }
+    
+    vector<SlowQuery> getSlowestQueries() {
+        return queryProfiler ? queryProfiler->getSlowestQueries() : vector<SlowQuery>();
+    }
+    
+    bool dumpQueryStatsJson(const string& path) {
+        if (!queryProfiler) return false;
+        
+        // IO call - write histograms and slowest queries for offline analysis
+        ofstream out(path);
+        if (!out.is_open()) {
+            cerr << "Failed to open query stats file: " << path << endl;
+            return false;
+        }
+        out << queryProfiler->dumpJson();
+        return true;
+    }
+    
+    bool enableQueryCache(size_t memoryBudgetBytes, chrono::milliseconds ttl) {
+        if (!initialized || !db || resultCache) return false;
+        
+        // Decision making - analyse dependencies on a separate connection so the writer's statements
+        // are not expired when the authorizer is installed; in-memory databases must share the writer
+        if (!databasePath.empty() && databasePath != ":memory:") {
+            if (sqlite3_open_v2(databasePath.c_str(), &analysisDb,
+                                SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX, nullptr) != SQLITE_OK) {
+                cerr << "Failed to open analysis connection: " << sqlite3_errmsg(analysisDb) << endl;
+                sqlite3_close(analysisDb);
+                analysisDb = nullptr;
+                return false;
+            }
+        } else {
+            analysisDb = db;
+        }
+        sqlite3_set_authorizer(analysisDb, &DatabaseManager::captureReadTables, nullptr);
+        
+        // Invalidate on the first change to each table per transaction and again once it is durable
+        tablesChangedInTransaction.clear();
+        resultCache.reset(new QueryResultCache(memoryBudgetBytes, ttl));
+        sqlite3_update_hook(db, &DatabaseManager::onRowChange, this);
+        sqlite3_commit_hook(db, &DatabaseManager::onCommit, this);
+        sqlite3_rollback_hook(db, &DatabaseManager::onRollback, this);
+        sqlite3_wal_hook(db, &DatabaseManager::onWalCommit, this);
+        return true;
+    }
+    
+    void disableQueryCache() {
+        if (!resultCache) return;
+        
+        sqlite3_update_hook(db, nullptr, nullptr);
+        sqlite3_commit_hook(db, nullptr, nullptr);
+        sqlite3_rollback_hook(db, nullptr, nullptr);
+        if (!backgroundCheckpointing) {
+            sqlite3_wal_autocheckpoint(db, walAutocheckpointFrames);
+        }
+        if (analysisDb == db) {
+            sqlite3_set_authorizer(db, nullptr, nullptr);
+        } else {
+            sqlite3_close(analysisDb);
+        }
+        analysisDb = nullptr;
+        resultCache.reset();
+        
+        lock_guard<mutex> lock(dependencyMutex);
+        queryDependencies.clear();
+    }
+    
+    map<string, double> getQueryCacheStats() {
+        return resultCache ? resultCache->getStats() : map<string, double>();
+    }
+    
+    void close() {
+        cancelBackups();
+        stopMaintenanceScheduler();
+        stopCheckpointer();
+        stopAsyncWriter();
+        readerPool.close();
+        if (db) {
+            disableQueryCache();
+            cleanupStatements();
+            writerStatements.reset();
+            sqlite3_close(db);
+            db = nullptr;
+        }
+        initialized = false;
+    }
+    
+    bool executeQuery(const string& query) {
+        if (!initialized || !db) return false;
+        
+        // Serialize with explicit transactions so a statement from another thread cannot land inside one
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        auto start = chrono::high_resolution_clock::now();
+        
+        // Decision making - sanitize query for security
+        string sanitizedQuery = sanitizeQuery(query);
+        
+        // Service call - reuse a cached statement so repeated SQL skips sqlite3_prepare_v2
+        bool hasTail = false;
+        sqlite3_stmt* stmt = writerStatements->acquire(sanitizedQuery, &hasTail);
+        
+        int result;
+        char* errorMsg = nullptr;
+        if (stmt) {
+            // Loop - step through any rows (e.g. from PRAGMA) until done
+            long long rows = 0;
+            while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+                rows++;
+            }
+            if (result == SQLITE_DONE) result = SQLITE_OK;
+            else errorMsg = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+            
+            if (queryProfiler) {
+                auto stepEnd = chrono::high_resolution_clock::now();
+                long long affected = sqlite3_stmt_readonly(stmt) ? 0 : sqlite3_changes(db);
+                queryProfiler->record(stmt, chrono::duration<double>(stepEnd - start).count(),
+                                      result == SQLITE_OK, rows, affected);
+            }
+            writerStatements->release(stmt);
+        } else if (hasTail) {
+            // Decision making - multi-statement scripts still go through sqlite3_exec
+            result = sqlite3_exec(db, sanitizedQuery.c_str(), nullptr, nullptr, &errorMsg);
+        } else {
+            result = sqlite3_errcode(db);
+            errorMsg = sqlite3_mprintf("%s", sqlite3_errmsg(db));
+        }
+        
+        auto end = chrono::high_resolution_clock::now();
+        double queryTime = chrono::duration<double>(end - start).count();
+        
+        bool success = (result == SQLITE_OK);
+        updatePerformanceMetrics(queryTime, success);
+        
+        // Decision making - schema changes and WHERE-less DELETEs bypass the update hook
+        if (success && resultCache && bypassesUpdateHook(sanitizedQuery)) {
+            resultCache->invalidateAll();
+        }
+        
+        // Decision making - schema changes can alter what a memoized query reads
+        if (success && resultCache && changesSchema(sanitizedQuery)) {
+            lock_guard<mutex> lock(dependencyMutex);
+            queryDependencies.clear();
+        }
+        
+        if (!success && errorMsg) {
+            cerr << "Query failed: " << errorMsg << endl;
+        }
+        sqlite3_free(errorMsg);
+        
+        return success;
+    }
+    
+    map<string, double> getStatementCacheStats() {
+        map<string, double> stats;
+        if (writerStatements) {
+            stats = writerStatements->getStats();
+        }
+        
+        // Loop - add pooled reader counters
+        for (const auto& stat : readerPool.getStats()) {
+            if (stat.first.find("statement_cache") != string::npos) {
+                stats[stat.first] = stat.second;
+            }
+        }
+        return stats;
+    }
+    
+    vector<map<string, string>> selectQuery(const string& query, const vector<string>& params = {}) {
+        // Decision making - serve repeated reads from the result cache when it is enabled
+        set<string> tables;
+        map<string, long long> generations;
+        string key;
+        if (resultCache && readTables(query, tables)) {
+            key = QueryResultCache::makeKey(query, params);
+            if (auto cached = resultCache->lookup(key)) {
+                return *cached;
+            }
+            generations = resultCache->generations(tables);
+        }
+        
+        vector<map<string, string>> results;
+        
+        // Loop - materialize each row; prefer forEachRow/openCursor for large scans
+        bool success = forEachRow(query, params, [&results](const RowCursor& row) {
+            map<string, string> columns;
+            for (int i = 0; i < row.columnCount(); ++i) {
+                columns[row.columnName(i)] = string(row.getText(i));
+            }
+            results.push_back(move(columns));
+            return true;
+        });
+        
+        if (success && !key.empty()) {
+            resultCache->insert(key, results, tables, generations);
+        }
+        return results;
+    }
+    
+    RowCursor openCursor(const string& query, const vector<string>& params = {}) {
+        if (!initialized || !db) {
+            return RowCursor(nullptr, nullptr, nullptr, nullptr);
+        }
+        
+        auto start = chrono::high_resolution_clock::now();
+        auto recordTime = [this, start](sqlite3_stmt* stmt, bool success, long long rows) {
+            auto end = chrono::high_resolution_clock::now();
+            double queryTime = chrono::duration<double>(end - start).count();
+            if (queryProfiler) {
+                queryProfiler->record(stmt, queryTime, success, rows, 0);
+            }
+            updatePerformanceMetrics(queryTime, success);
+        };
+        
+        // Decision making - read on a pooled connection when available so readers run in parallel
+        if (readerPool.isOpen()) {
+            unique_ptr<ConnectionPool::Lease> lease(new ConnectionPool::Lease(readerPool.acquire()));
+            if (!lease->get()) {
+                return RowCursor(nullptr, nullptr, nullptr, nullptr);
+            }
+            StatementCache* cache = &(*lease)->statements;
+            sqlite3_stmt* stmt = bindParams(cache->acquire(query), params);
+            return RowCursor(stmt, cache, move(lease), recordTime);
+        }
+        
+        sqlite3_stmt* stmt = bindParams(writerStatements->acquire(query), params);
+        return RowCursor(stmt, writerStatements.get(), nullptr, recordTime);
+    }
+    
+    bool forEachRow(const string& query, const function<bool(const RowCursor&)>& visitor) {
+        return forEachRow(query, {}, visitor);
+    }
+    
+    bool forEachRow(const string& query, const vector<string>& params, const function<bool(const RowCursor&)>& visitor) {
+        RowCursor cursor = openCursor(query, params);
+        
+        // Loop - visit rows in constant memory; the visitor returns false to stop early
+        while (cursor.next()) {
+            if (!visitor(cursor)) break;
+        }
+        
+        bool success = cursor.ok();
+        cursor.close();
+        return success;
+    }
+    
+    bool executePreparedQuery(const string& name, const vector<string>& params) {
+        return executePreparedBatch(name, {params});
+    }
+    
+    bool executePreparedBatch(const string& name, const vector<vector<string>>& rows) {
+        if (!initialized || !db) return false;
+        if (rows.empty()) return true;
+        
+        // Decision making - only statements prepared in prepareStatements are accepted
+        auto it = preparedStatements.find(name);
+        if (it == preparedStatements.end()) {
+            cerr << "Unknown prepared statement: " << name << endl;
+            return false;
+        }
+        sqlite3_stmt* stmt = it->second;
+        int paramCount = sqlite3_bind_parameter_count(stmt);
+        
+        auto start = chrono::high_resolution_clock::now();
+        
+        // One transaction for the whole batch instead of one per row
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        if (!executeQuery("BEGIN TRANSACTION")) {
+            return false;
+        }
+        
+        bool success = true;
+        int changesBefore = sqlite3_total_changes(db);
+        
+        // Loop - bind and execute each row against the cached statement
+        for (const auto& row : rows) {
+            if (static_cast<int>(row.size()) < paramCount) {
+                success = false;
+                break;
+            }
+            
+            for (int i = 0; i < paramCount; ++i) {
+                sqlite3_bind_text(stmt, i + 1, row[i].c_str(), static_cast<int>(row[i].size()), SQLITE_STATIC);
+            }
+            
+            int result = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+            
+            if (result != SQLITE_DONE) {
+                cerr << "Prepared insert failed: " << sqlite3_errmsg(db) << endl;
+                success = false;
+                break;
+            }
+        }
+        profileWrite(stmt, start, success, sqlite3_total_changes(db) - changesBefore);
+        
+        // Decision making - a failed COMMIT (e.g. SQLITE_BUSY) leaves the transaction open, so roll it back too
+        if (success) {
+            success = executeQuery("COMMIT");
+        }
+        if (!success) {
+            executeQuery("ROLLBACK");
+        }
+        
+        auto end = chrono::high_resolution_clock::now();
+        double queryTime = chrono::duration<double>(end - start).count();
+        updatePerformanceMetrics(queryTime, success);
+        
+        return success;
+    }
+    
+    bool shouldUseConnectionPool() {
+        // Decision making based on current load
+        double connectionEfficiency = calculateConnectionEfficiency();
+        return connectionEfficiency < 0.7 && currentConnections < 10;
+    }
+    
+    string selectOptimizationStrategy(const string& query) {
+        // Decision making based on the real query plan when one is available
+        QueryProfile profile;
+        if (queryProfiler && queryProfiler->findProfile(StatementCache::normalizeSql(query), profile)) {
+            // Measured plan from previous executions
+        } else if (initialized && db) {
+            profile.plan = QueryProfiler::explainPlan(db, StatementCache::normalizeSql(query));
+            QueryProfiler::classifyPlan(profile);
+        }
+        
+        if (!profile.plan.empty()) {
+            if (profile.fullTableScan || profile.missingIndex) {
+                return "indexed";   // needs an index
+            } else if (profile.tempSort) {
+                return "optimized"; // index lookups, but sorts in a temp b-tree
+            }
+            return "simple";
+        }
+        
+        // Decision making - fall back to the keyword heuristic for SQL that cannot be explained
+        int complexity = estimateQueryComplexity(query);
+        
+        if (complexity < 5) {
+            return "simple";
+        } else if (complexity < 15) {
+            return "indexed";
+        } else {
+            return "optimized";
+        }
+    }
+    
+    bool shouldEnableWAL(const string& operation) {
+        // Decision making - enable WAL for write operations
+        return operation == "initialize" || operation == "batch_insert" || operation == "update";
+    }
+    
+    double calculateQueryPerformance(const string& query) {
+        // Calculation - measured average when the profiler has seen this query
+        QueryProfile profile;
+        if (queryProfiler && queryProfiler->findProfile(StatementCache::normalizeSql(query), profile) &&
+            profile.executions > 0) {
+            return profile.totalTime / profile.executions;
+        }
+        
+        // Calculation - estimate performance based on query characteristics
+        int complexity = estimateQueryComplexity(query);
+        double baseTime = complexity * 0.001;
+        
+        // Decision making - adjust based on database state
+        if (totalQueries > 1000) {
+            baseTime *= 1.2; // Slight degradation over time
+        }
+        
+        return baseTime;
+    }
+    
+    int estimateQueryComplexity(const string& query) {
+        // Calculation - estimate complexity based on query structure
+        int complexity = 0;
+        
+        // Loop - count different SQL keywords
+        vector<string> keywords = {"SELECT", "FROM", "WHERE", "JOIN", "GROUP BY", "ORDER BY", "HAVING"};
+        for (const auto& keyword : keywords) {
+            if (query.find(keyword) != string::npos) {
+                complexity += 2;
+            }
+        }
+        
+        // Decision making - adjust complexity based on query length
+        if (query.length() > 500) {
+            complexity += 5;
+        }
+        
+        return complexity;
+    }
+    
+    double calculateConnectionEfficiency() {
+        // Calculation - efficiency based on success rate
+        if (totalQueries == 0) return 1.0;
+        
+        double successRate = static_cast<double>(totalQueries - failedQueries) / totalQueries;
+        double timeEfficiency = max(0.1, 1.0 - averageQueryTime);
+        
+        return (successRate + timeEfficiency) / 2.0;
+    }
+    
+    bool batchInsert(const vector<vector<string>>& data) {
+        if (!initialized || data.empty()) return false;
+        
+        auto singleIt = preparedStatements.find("insert_record");
+        auto multiIt = preparedStatements.find("insert_record_multi");
+        if (singleIt == preparedStatements.end() || multiIt == preparedStatements.end()) {
+            return false;
+        }
+        
+        auto start = chrono::high_resolution_clock::now();
+        
+        // Loop - collect valid rows so full multi-row tuples can be bound
+        vector<const vector<string>*> validRows;
+        validRows.reserve(data.size());
+        for (const auto& row : data) {
+            if (row.size() < 3) continue; // Skip invalid rows
+            validRows.push_back(&row);
+        }
+        
+        // Decision making - use transaction for batch operations
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        if (!executeQuery("BEGIN TRANSACTION")) {
+            return false;
+        }
+        
+        bool success = true;
+        size_t position = 0;
+        
+        // Loop - insert full chunks through the multi-row VALUES statement
+        auto phaseStart = chrono::high_resolution_clock::now();
+        int changesBefore = sqlite3_total_changes(db);
+        if (validRows.size() >= batchInsertRowsPerStatement) {
+            while (success && validRows.size() - position >= batchInsertRowsPerStatement) {
+                success = insertRows(multiIt->second, validRows, position, batchInsertRowsPerStatement);
+                position += batchInsertRowsPerStatement;
+            }
+            profileWrite(multiIt->second, phaseStart, success, sqlite3_total_changes(db) - changesBefore);
+        }
+        
+        // Loop - insert the remainder row by row through the single-row statement
+        if (success && position < validRows.size()) {
+            phaseStart = chrono::high_resolution_clock::now();
+            changesBefore = sqlite3_total_changes(db);
+            while (success && position < validRows.size()) {
+                success = insertRows(singleIt->second, validRows, position, 1);
+                position++;
+            }
+            profileWrite(singleIt->second, phaseStart, success, sqlite3_total_changes(db) - changesBefore);
+        }
+        
+        if (success) {
+            success = executeQuery("COMMIT");
+        }
+        if (!success) {
+            executeQuery("ROLLBACK");
+        }
+        
+        auto end = chrono::high_resolution_clock::now();
+        double batchTime = chrono::duration<double>(end - start).count();
+        updatePerformanceMetrics(batchTime, success);
+        
+        // Calculation - throughput of the last batch
+        if (success && batchTime > 0.0) {
+            lastBatchRowsPerSecond = validRows.size() / batchTime;
+        }
+        
+        return success;
+    }
+    
+    map<string, double> bulkImportCsv(const string& csvPath, bool hasHeader = true) {
+        map<string, double> report;
+        if (!initialized) return report;
+        
+        auto multiIt = preparedStatements.find("insert_record_multi");
+        auto singleIt = preparedStatements.find("insert_record");
+        if (multiIt == preparedStatements.end() || singleIt == preparedStatements.end()) return report;
+        
+        // IO call - map the whole file read-only; fields are bound straight out of the mapping
+        int fd = open(csvPath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Failed to open CSV file: " << csvPath << endl;
+            return report;
+        }
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size == 0) {
+            ::close(fd);
+            return report;
+        }
+        size_t fileSize = static_cast<size_t>(fileInfo.st_size);
+        void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            cerr << "Failed to map CSV file: " << csvPath << endl;
+            return report;
+        }
+        madvise(mapping, fileSize, MADV_SEQUENTIAL);
+        
+        auto start = chrono::high_resolution_clock::now();
+        const char* data = static_cast<const char*>(mapping);
+        const char* end = data + fileSize;
+        
+        // Two-column rows get the import time, matching the column default
+        string importTime;
+        forEachRow("SELECT datetime('now')", [&importTime](const RowCursor& row) {
+            importTime = string(row.getText(0));
+            return false;
+        });
+        
+        // Calculation - rebuilding secondary indexes only pays off when the import is large next to
+        // the table; the record estimate counts newlines, which over-counts quoted line breaks
+        long long existingRows = 0;
+        forEachRow("SELECT COALESCE(MAX(id), 0) FROM data_records", [&existingRows](const RowCursor& row) {
+            existingRows = row.getInt64(0);
+            return false;
+        });
+        long long estimatedRows = 0;
+        for (const char* p = data; p < end; ++estimatedRows) {
+            const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+            p = newline ? newline + 1 : end;
+        }
+        bool rebuildIndexes = estimatedRows >= existingRows * bulkImportIndexRebuildRatio;
+        
+        vector<pair<string, string>> indexes;
+        if (rebuildIndexes) {
+            forEachRow("SELECT name, sql FROM sqlite_master WHERE type = 'index' AND tbl_name = 'data_records' "
+                       "AND sql IS NOT NULL", [&indexes](const RowCursor& row) {
+                indexes.emplace_back(string(row.getText(0)), string(row.getText(1)));
+                return true;
+            });
+        }
+        
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        bool success = executeQuery("BEGIN TRANSACTION");
+        for (const auto& index : indexes) {
+            success = success && executeQuery("DROP INDEX IF EXISTS " + index.first);
+        }
+        
+        // Pending rows hold pointers into the mapping, or into quotedFields for unescaped values
+        vector<array<CsvField, 3>> pending;
+        pending.reserve(batchInsertRowsPerStatement);
+        deque<string> quotedFields;
+        long long rows = 0, badRows = 0;
+        
+        const char* cursor = data;
+        array<CsvField, 3> fields;
+        int fieldCount = 0;
+        if (hasHeader && cursor < end) {
+            parseCsvRecord(cursor, end, fields, fieldCount, quotedFields);
+            quotedFields.clear();
+        }
+        
+        // Loop - one pass over the mapping, one RFC 4180 record at a time
+        while (success && cursor < end) {
+            bool wellFormed = parseCsvRecord(cursor, end, fields, fieldCount, quotedFields);
+            
+            // Decision making - blank lines are ignored; rows need name and value plus an optional
+            // timestamp, so malformed rows and rows with extra columns are rejected, not truncated
+            if (wellFormed && fieldCount == 1 && fields[0].length == 0) continue;
+            if (!wellFormed || fieldCount < 2 || fieldCount > 3) {
+                badRows++;
+                continue;
+            }
+            if (fieldCount == 2) {
+                fields[2] = {importTime.data(), static_cast<int>(importTime.size())};
+            }
+            
+            pending.push_back(fields);
+            rows++;
+            
+            if (pending.size() == batchInsertRowsPerStatement) {
+                success = bindCsvRows(multiIt->second, pending, 0, pending.size());
+                pending.clear();
+                quotedFields.clear();
+            }
+        }
+        
+        // Loop - the final partial chunk goes through the single-row insert
+        for (size_t r = 0; success && r < pending.size(); ++r) {
+            success = bindCsvRows(singleIt->second, pending, r, 1);
+        }
+        
+        // Rebuild the dropped indexes once, inside the same transaction
+        for (const auto& index : indexes) {
+            success = success && executeQuery(index.second);
+        }
+        
+        if (success) {
+            success = executeQuery("COMMIT");
+        } else {
+            executeQuery("ROLLBACK");
+        }
+        
+        munmap(mapping, fileSize);
+        
+        auto finish = chrono::high_resolution_clock::now();
+        double seconds = chrono::duration<double>(finish - start).count();
+        updatePerformanceMetrics(seconds, success);
+        
+        // Calculation - load report
+        report["success"] = success ? 1.0 : 0.0;
+        report["rows"] = success ? static_cast<double>(rows) : 0.0;
+        report["bad_rows"] = static_cast<double>(badRows);
+        report["indexes_rebuilt"] = success ? static_cast<double>(indexes.size()) : 0.0;
+        report["seconds"] = seconds;
+        report["rows_per_second"] = success && seconds > 0.0 ? rows / seconds : 0.0;
+        return report;
+    }
+    
+    long long cleanupOldRecords(int daysOld, int chunkRows = 1000,
+                                chrono::milliseconds pauseBetweenChunks = chrono::milliseconds(2)) {
+        if (!initialized) return 0;
+        if (chunkRows <= 0) {
+            cerr << "Retention chunk size must be positive" << endl;
+            return 0;
+        }
+        
+        // Calculation - determine cutoff date once so every chunk uses the same boundary
+        string cutoff;
+        forEachRow("SELECT datetime('now', '-" + to_string(daysOld) + " days')", [&cutoff](const RowCursor& row) {
+            cutoff = string(row.getText(0));
+            return false;
+        });
+        if (cutoff.empty()) return 0;
+        
+        long long deleted = 0;
+        
+        // Loop - delete the oldest chunkRows expired rows until a chunk comes up short; ordering by
+        // timestamp keeps the subquery a covering search of idx_data_records_timestamp, so even the
+        // last, empty chunk holds the write lock only for an index probe
+        while (true) {
+            int changed = 0;
+            {
+                lock_guard<recursive_mutex> transactionLock(transactionMutex);
+                sqlite3_stmt* stmt = writerStatements->acquire(
+                    "DELETE FROM data_records WHERE id IN "
+                    "(SELECT id FROM data_records WHERE timestamp < ? ORDER BY timestamp LIMIT ?)");
+                if (!stmt) break;
+                
+                auto start = chrono::high_resolution_clock::now();
+                sqlite3_bind_text(stmt, 1, cutoff.c_str(), static_cast<int>(cutoff.size()), SQLITE_STATIC);
+                sqlite3_bind_int(stmt, 2, chunkRows);
+                bool success = sqlite3_step(stmt) == SQLITE_DONE;
+                if (success) changed = sqlite3_changes(db);
+                profileWrite(stmt, start, success, changed);
+                writerStatements->release(stmt);
+                
+                auto end = chrono::high_resolution_clock::now();
+                updatePerformanceMetrics(chrono::duration<double>(end - start).count(), success);
+                if (!success) {
+                    cerr << "Retention chunk failed: " << sqlite3_errmsg(db) << endl;
+                    break;
+                }
+            }
+            
+            deleted += changed;
+            if (changed < chunkRows) break;
+            this_thread::sleep_for(pauseBetweenChunks);
+        }
+        
+        return deleted;
+    }
+    
+    bool enablePartitioning() {
+        if (!initialized) return false;
+        
+        // Decision making - an all-partitions view would hit SQLite's compound SELECT limit and force
+        // DDL per new day, so queries go to the partition tables through selectTimeRange instead
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        if (!executeQuery("DROP VIEW IF EXISTS data_records_partitioned")) return false;
+        loadPartitions();
+        partitioningEnabled = true;
+        return true;
+    }
+    
+    bool insertPartitioned(const vector<vector<string>>& data) {
+        if (!initialized || !partitioningEnabled || data.empty()) return false;
+        
+        auto start = chrono::high_resolution_clock::now();
+        
+        // Loop - route each row to the partition of its timestamp's day
+        map<string, vector<const vector<string>*>> rowsByDay;
+        for (const auto& row : data) {
+            if (row.size() < 3) continue; // Skip invalid rows
+            rowsByDay[partitionDay(row[2])].push_back(&row);
+        }
+        
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        if (!executeQuery("BEGIN TRANSACTION")) {
+            return false;
+        }
+        
+        bool success = true;
+        size_t inserted = 0;
+        for (const auto& day : rowsByDay) {
+            if (!ensurePartition(day.first)) {
+                success = false;
+                break;
+            }
+            
+            // Loop - one cached insert statement per partition, reused for every row of that day
+            sqlite3_stmt* stmt = writerStatements->acquire(
+                "INSERT INTO " + partitionTable(day.first) + " (name, value, timestamp) VALUES (?, ?, ?)");
+            for (size_t i = 0; success && stmt && i < day.second.size(); ++i) {
+                success = insertRows(stmt, day.second, i, 1);
+            }
+            if (!stmt) success = false;
+            writerStatements->release(stmt);
+            if (!success) break;
+            inserted += day.second.size();
+        }
+        
+        if (!success) {
+            // Partitions created inside the failed transaction no longer exist
+            executeQuery("ROLLBACK");
+            loadPartitions();
+        } else {
+            success = executeQuery("COMMIT");
+        }
+        
+        auto end = chrono::high_resolution_clock::now();
+        double batchTime = chrono::duration<double>(end - start).count();
+        updatePerformanceMetrics(batchTime, success);
+        if (success && batchTime > 0.0) {
+            lastBatchRowsPerSecond = inserted / batchTime;
+        }
+        
+        return success;
+    }
+    
+    vector<map<string, string>> selectTimeRange(const string& fromTimestamp, const string& toTimestamp,
+                                                const string& columns = "*", const string& suffix = "") {
+        // Decision making - only partitions whose day overlaps [from, to) take part in the query
+        string firstDay = partitionDay(fromTimestamp);
+        string lastDay = partitionDay(toTimestamp);
+        vector<string> days;
+        {
+            lock_guard<mutex> lock(partitionMutex);
+            for (auto it = partitionDays.lower_bound(firstDay); it != partitionDays.end() && *it <= lastDay; ++it) {
+                days.push_back(*it);
+            }
+        }
+        if (days.empty()) return {};
+        
+        // Calculation - pruned UNION ALL, each branch filtered through its own timestamp index; the
+        // branches share ?1 and ?2, and long ranges nest chunks of at most the compound SELECT limit
+        size_t maxTerms = static_cast<size_t>(max(2, sqlite3_limit(db, SQLITE_LIMIT_COMPOUND_SELECT, -1)));
+        string sql = "SELECT " + columns + " FROM (";
+        for (size_t chunk = 0; chunk < days.size(); chunk += maxTerms) {
+            size_t chunkEnd = min(days.size(), chunk + maxTerms);
+            bool nested = days.size() > maxTerms;
+            if (chunk > 0) sql += " UNION ALL ";
+            if (nested) sql += "SELECT id, name, value, timestamp FROM (";
+            for (size_t i = chunk; i < chunkEnd; ++i) {
+                if (i > chunk) sql += " UNION ALL ";
+                sql += "SELECT id, name, value, timestamp FROM " + partitionTable(days[i]) +
+                       " WHERE timestamp >= ?1 AND timestamp < ?2";
+            }
+            if (nested) sql += ")";
+        }
+        sql += ")";
+        if (!suffix.empty()) sql += " " + suffix;
+        
+        return selectQuery(sql, {fromTimestamp, toTimestamp});
+    }
+    
+    int dropPartitionsOlderThan(int daysOld) {
+        if (!initialized || !partitioningEnabled) return 0;
+        
+        string cutoff;
+        forEachRow("SELECT strftime('%Y%m%d', 'now', '-" + to_string(daysOld) + " days')", [&cutoff](const RowCursor& row) {
+            cutoff = string(row.getText(0));
+            return false;
+        });
+        if (cutoff.empty()) return 0;
+        
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        vector<string> expired;
+        {
+            lock_guard<mutex> lock(partitionMutex);
+            expired.assign(partitionDays.begin(), partitionDays.lower_bound(cutoff));
+        }
+        if (expired.empty()) return 0;
+        
+        // Loop - retention is one DROP per day regardless of how many rows the day holds
+        int dropped = 0;
+        if (!executeQuery("BEGIN TRANSACTION")) return 0;
+        for (const auto& day : expired) {
+            if (!executeQuery("DROP TABLE IF EXISTS " + partitionTable(day))) break;
+            dropped++;
+        }
+        
+        {
+            lock_guard<mutex> lock(partitionMutex);
+            for (int i = 0; i < dropped; ++i) {
+                partitionDays.erase(expired[i]);
+            }
+        }
+        
+        if (!executeQuery("COMMIT")) {
+            executeQuery("ROLLBACK");
+            loadPartitions();
+            return 0;
+        }
+        return dropped;
+    }
+    
+    vector<string> getPartitions() {
+        lock_guard<mutex> lock(partitionMutex);
+        return vector<string>(partitionDays.begin(), partitionDays.end());
+    }
+    
+    bool convertToIncrementalVacuum() {
+        if (!initialized) return false;
+        if (pragmaValue("PRAGMA auto_vacuum") == 2) return true;
+        
+        // Service call - one full VACUUM rewrites the file; run it in a maintenance window
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        auto start = chrono::steady_clock::now();
+        if (!executeQuery("PRAGMA auto_vacuum=INCREMENTAL") || !executeQuery("VACUUM") ||
+            !executeQuery("PRAGMA user_version = 2")) {
+            return false;
+        }
+        
+        cout << "Converted to incremental auto-vacuum in "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+        return true;
+    }
+    
+    map<string, double> optimizeDatabase(chrono::milliseconds timeBudget = chrono::milliseconds(200)) {
+        // Service calls - bounded incremental maintenance instead of full VACUUM/ANALYZE/REINDEX
+        return runMaintenance(timeBudget);
+    }
+    
+    map<string, double> runMaintenance(chrono::milliseconds timeBudget) {
+        map<string, double> report;
+        if (!initialized) return report;
+        
+        auto start = chrono::steady_clock::now();
+        auto deadline = start + timeBudget;
+        
+        // Calculation - real probe latency before maintenance
+        report["probe_before_ms"] = probeQueryLatency();
+        
+        // Service call - refresh statistics the planner actually needs, with bounded analysis work;
+        // every step holds the writer's transaction lock so it never lands inside another transaction
+        {
+            lock_guard<recursive_mutex> transactionLock(transactionMutex);
+            executeQuery("PRAGMA analysis_limit=400");
+            report["optimized"] = executeQuery("PRAGMA optimize") ? 1.0 : 0.0;
+        }
+        
+        // Loop - return free pages to the OS in small steps until done or out of budget,
+        // releasing the lock between steps so writers are delayed by one step at most
+        long long freeBefore = pragmaValue("PRAGMA freelist_count");
+        long long freeNow = freeBefore;
+        while (freeNow > 0 && chrono::steady_clock::now() < deadline) {
+            lock_guard<recursive_mutex> transactionLock(transactionMutex);
+            if (!executeQuery("PRAGMA incremental_vacuum(" + to_string(maintenancePagesPerStep) + ")")) break;
+            freeNow = pragmaValue("PRAGMA freelist_count");
+        }
+        
+        report["pages_freed"] = static_cast<double>(freeBefore - freeNow);
+        report["pages_free_remaining"] = static_cast<double>(freeNow);
+        report["budget_exhausted"] = chrono::steady_clock::now() >= deadline ? 1.0 : 0.0;
+        report["auto_vacuum_conversion_pending"] = pragmaValue("PRAGMA auto_vacuum") != 2 ? 1.0 : 0.0;
+        
+        // Calculation - real probe latency after maintenance
+        report["probe_after_ms"] = probeQueryLatency();
+        report["elapsed_ms"] = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        
+        lock_guard<mutex> lock(metricsMutex);
+        lastMaintenanceReport = report;
+        return report;
+    }
+    
+    bool startMaintenanceScheduler(chrono::milliseconds idleThreshold, chrono::milliseconds checkInterval,
+                                   chrono::milliseconds timeBudget) {
+        if (!initialized || maintenanceRunning) return false;
+        
+        maintenanceRunning = true;
+        maintenanceThread = thread([this, idleThreshold, checkInterval, timeBudget]() {
+            unique_lock<mutex> lock(maintenanceMutex);
+            
+            // Loop - run maintenance only during idle windows
+            while (maintenanceRunning) {
+                maintenanceWake.wait_for(lock, checkInterval, [this]() { return !maintenanceRunning; });
+                if (!maintenanceRunning) break;
+                
+                auto idleFor = chrono::steady_clock::now().time_since_epoch() -
+                               chrono::steady_clock::duration(lastActivity.load());
+                if (idleFor < idleThreshold) continue;
+                
+                lock.unlock();
+                runMaintenance(timeBudget);
+                lock.lock();
+            }
+        });
+        return true;
+    }
+    
+    void stopMaintenanceScheduler() {
+        if (!maintenanceRunning) return;
+        {
+            lock_guard<mutex> lock(maintenanceMutex);
+            maintenanceRunning = false;
+        }
+        maintenanceWake.notify_one();
+        maintenanceThread.join();
+    }
+    
+    map<string, double> getLastMaintenanceReport() {
+        lock_guard<mutex> lock(metricsMutex);
+        return lastMaintenanceReport;
+    }
+    
+    bool startCheckpointer(long long passiveFrames = 1000, long long restartFrames = 10000,
+                           chrono::milliseconds idleThreshold = chrono::milliseconds(200),
+                           chrono::milliseconds checkInterval = chrono::milliseconds(50)) {
+        if (!initialized || checkpointerRunning) return false;
+        if (databasePath.empty() || databasePath == ":memory:") return false;
+        
+        // Service call - checkpoints run on their own connection so commits are never stalled behind them
+        if (sqlite3_open_v2(databasePath.c_str(), &checkpointDb, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK) {
+            cerr << "Failed to open checkpoint connection: " << sqlite3_errmsg(checkpointDb) << endl;
+            sqlite3_close(checkpointDb);
+            checkpointDb = nullptr;
+            return false;
+        }
+        sqlite3_busy_timeout(checkpointDb, 100);
+        
+        // A connection only attaches to the WAL after its first read; until then checkpoints are no-ops
+        sqlite3_exec(checkpointDb, "SELECT COUNT(*) FROM sqlite_master", nullptr, nullptr, nullptr);
+        
+        // Installing the WAL hook disables SQLite's inline auto-checkpoint on the writer
+        checkpointPassiveFrames = max<long long>(passiveFrames, 1);
+        backgroundCheckpointing = true;
+        sqlite3_wal_hook(db, &DatabaseManager::onWalCommit, this);
+        
+        checkpointerRunning = true;
+        checkpointThread = thread(&DatabaseManager::runCheckpointer, this,
+                                  max(restartFrames, checkpointPassiveFrames), idleThreshold, checkInterval);
+        return true;
+    }
+    
+    void stopCheckpointer() {
+        if (!checkpointerRunning) return;
+        {
+            lock_guard<mutex> lock(checkpointMutex);
+            checkpointerRunning = false;
+        }
+        checkpointWake.notify_one();
+        checkpointThread.join();
+        
+        // Decision making - hand checkpoints back to SQLite unless the result cache still owns the hook
+        backgroundCheckpointing = false;
+        if (!resultCache) {
+            sqlite3_wal_autocheckpoint(db, walAutocheckpointFrames);
+        }
+        sqlite3_close(checkpointDb);
+        checkpointDb = nullptr;
+    }
+    
+    map<string, double> getCheckpointStats() {
+        map<string, double> stats;
+        {
+            lock_guard<mutex> lock(metricsMutex);
+            stats = checkpointStats;
+        }
+        
+        // Calculation - WAL size as last reported by a commit, and as it is on disk
+        long long pageSize = pragmaValue("PRAGMA page_size");
+        stats["wal_frames"] = static_cast<double>(walFrames.load());
+        stats["wal_bytes"] = static_cast<double>(walFrames.load() * (pageSize + 24));
+        struct stat walFile;
+        stats["wal_file_bytes"] = stat((databasePath + "-wal").c_str(), &walFile) == 0
+                                  ? static_cast<double>(walFile.st_size) : 0.0;
+        return stats;
+    }
+    
+    bool backupDatabase(const string& backupPath, int pagesPerStep = 256,
+                        chrono::milliseconds pauseBetweenSteps = chrono::milliseconds(5),
+                        function<void(int remaining, int total)> progress = nullptr) {
+        if (!initialized) return false;
+        
+        // Service call - open the destination (created if missing)
+        sqlite3* backupDb;
+        int result = sqlite3_open(backupPath.c_str(), &backupDb);
+        if (result != SQLITE_OK) {
+            cerr << "Failed to open backup file: " << sqlite3_errmsg(backupDb) << endl;
+            sqlite3_close(backupDb);
+            return false;
+        }
+        
+        sqlite3_backup* backup = sqlite3_backup_init(backupDb, "main", db, "main");
+        if (!backup) {
+            cerr << "Failed to start backup: " << sqlite3_errmsg(backupDb) << endl;
+            sqlite3_close(backupDb);
+            return false;
+        }
+        
+        const int maxBusyRetries = 100;
+        int busyRetries = 0;
+        
+        // Loop - copy a bounded number of pages per step so live traffic gets the locks in between
+        do {
+            result = sqlite3_backup_step(backup, pagesPerStep);
+            
+            if (progress) {
+                progress(sqlite3_backup_remaining(backup), sqlite3_backup_pagecount(backup));
+            }
+            
+            // Decision making - close() is waiting for this backup
+            if (backupsCancelled) {
+                result = SQLITE_INTERRUPT;
+                break;
+            }
+            
+            // Decision making - back off and retry while the source is busy or locked
+            if (result == SQLITE_BUSY || result == SQLITE_LOCKED) {
+                if (++busyRetries > maxBusyRetries) break;
+                this_thread::sleep_for(pauseBetweenSteps * 2);
+                continue;
+            }
+            busyRetries = 0;
+            
+            if (result == SQLITE_OK) {
+                this_thread::sleep_for(pauseBetweenSteps);
+            }
+        } while (result == SQLITE_OK || result == SQLITE_BUSY || result == SQLITE_LOCKED);
+        
+        sqlite3_backup_finish(backup);
+        
+        bool success = (result == SQLITE_DONE);
+        if (!success) {
+            cerr << "Backup failed: " << sqlite3_errstr(result) << endl;
+        }
+        
+        sqlite3_close(backupDb);
+        return success;
+    }
+    
+    future<bool> backupDatabaseAsync(const string& backupPath, int pagesPerStep = 256,
+                                     chrono::milliseconds pauseBetweenSteps = chrono::milliseconds(5),
+                                     function<void(int remaining, int total)> progress = nullptr) {
+        // Service call - run the incremental backup on a tracked background thread
+        auto done = make_shared<promise<bool>>();
+        future<bool> result = done->get_future();
+        
+        auto finished = make_shared<atomic<bool>>(false);
+        
+        lock_guard<mutex> lock(backupMutex);
+        
+        // Loop - reap backups that have already completed
+        for (auto it = backupTasks.begin(); it != backupTasks.end();) {
+            if (*it->finished) {
+                it->worker.join();
+                it = backupTasks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        thread worker([this, done, finished, backupPath, pagesPerStep, pauseBetweenSteps, progress]() {
+            done->set_value(backupDatabase(backupPath, pagesPerStep, pauseBetweenSteps, progress));
+            *finished = true;
+        });
+        backupTasks.push_back(BackupTask{move(worker), finished});
+        return result;
+    }
+    
+    void cancelBackups() {
+        list<BackupTask> running;
+        {
+            lock_guard<mutex> lock(backupMutex);
+            running.swap(backupTasks);
+        }
+        if (running.empty()) return;
+        
+        // Loop - in-flight backups stop at their next step; their futures report false
+        backupsCancelled = true;
+        for (auto& task : running) {
+            task.worker.join();
+        }
+        backupsCancelled = false;
+    }
+    
+    bool validateDatabaseIntegrity() {
+        // Service call - integrity check
+        auto result = selectQuery("PRAGMA integrity_check");
+        return !result.empty() && result[0]["integrity_check"] == "ok";
+    }
+    
+private:
+    void wakeAsyncWriter() {
+        // Taking the mutex orders the notify after a parked writer's queue check
+        {
+            lock_guard<mutex> lock(asyncWakeMutex);
+        }
+        asyncWake.notify_one();
+    }
+    
+    void runAsyncWriter() {
+        vector<WriteRequest*> group;
+        group.reserve(groupCommitSize);
+        
+        // Loop - collect a group by size or deadline, then commit it in one transaction
+        while (true) {
+            auto deadline = chrono::steady_clock::now() + groupCommitDelay;
+            
+            while (group.size() < groupCommitSize) {
+                WriteRequest* request = writeQueue.pop();
+                if (request) {
+                    group.push_back(request);
+                    continue;
+                }
+                
+                // Decision making - commit early when stopping or when the deadline has passed
+                if (!asyncWriterRunning || (!group.empty() && chrono::steady_clock::now() >= deadline)) break;
+                
+                // Park until woken; the timed wait also bounds any wakeup missed between the checks
+                unique_lock<mutex> lock(asyncWakeMutex);
+                asyncWriterIdle.store(true, memory_order_release);
+                if (writeQueue.empty() && asyncWriterRunning) {
+                    asyncWake.wait_until(lock, group.empty() ? chrono::steady_clock::now() + chrono::milliseconds(100) : deadline);
+                }
+                asyncWriterIdle.store(false, memory_order_release);
+                if (group.empty()) deadline = chrono::steady_clock::now() + groupCommitDelay;
+            }
+            
+            if (group.empty()) {
+                if (!asyncWriterRunning) break;
+                continue;
+            }
+            
+            commitGroup(group);
+            group.clear();
+        }
+    }
+    
+    void commitGroup(vector<WriteRequest*>& group) {
+        lock_guard<recursive_mutex> transactionLock(transactionMutex);
+        vector<bool> applied(group.size(), false);
+        
+        // Decision making - WAL with synchronous=NORMAL can lose the last commits on power loss,
+        // so acknowledged groups are committed with FULL and the connection setting is restored after
+        long long synchronousMode = 2;
+        if (sqlite3_stmt* stmt = writerStatements->acquire("PRAGMA synchronous")) {
+            if (sqlite3_step(stmt) == SQLITE_ROW) synchronousMode = sqlite3_column_int64(stmt, 0);
+            writerStatements->release(stmt);
+        }
+        if (synchronousMode < 2) {
+            executeQuery("PRAGMA synchronous=FULL");
+        }
+        bool began = executeQuery("BEGIN TRANSACTION");
+        
+        // Loop - each request runs under a savepoint so one bad row does not fail the group
+        for (size_t i = 0; began && i < group.size(); ++i) {
+            WriteRequest* request = group[i];
+            sqlite3_stmt* stmt = writerStatements->acquire(request->sql);
+            if (!stmt) continue;
+            
+            executeQuery("SAVEPOINT async_write");
+            for (size_t p = 0; p < request->params.size(); ++p) {
+                const string& param = request->params[p];
+                sqlite3_bind_text(stmt, static_cast<int>(p + 1), param.c_str(), static_cast<int>(param.size()), SQLITE_STATIC);
+            }
+            
+            auto stepStart = chrono::high_resolution_clock::now();
+            int result = sqlite3_step(stmt);
+            applied[i] = (result == SQLITE_DONE || result == SQLITE_ROW);
+            profileWrite(stmt, stepStart, applied[i], applied[i] && !sqlite3_stmt_readonly(stmt) ? sqlite3_changes(db) : 0);
+            writerStatements->release(stmt);
+            
+            executeQuery(applied[i] ? "RELEASE async_write" : "ROLLBACK TO async_write");
+            if (!applied[i]) {
+                executeQuery("RELEASE async_write");
+            }
+        }
+        
+        bool committed = began && executeQuery("COMMIT");
+        if (began && !committed) {
+            executeQuery("ROLLBACK");
+        }
+        if (synchronousMode < 2) {
+            executeQuery("PRAGMA synchronous=" + to_string(synchronousMode));
+        }
+        
+        asyncCommits++;
+        asyncWrites += static_cast<long long>(group.size());
+        
+        // Loop - acknowledge durability only after the commit
+        for (size_t i = 0; i < group.size(); ++i) {
+            group[i]->durable.set_value(committed && applied[i]);
+            delete group[i];
+        }
+    }
+    
+    long long pragmaValue(const string& pragma) {
+        long long value = 0;
+        forEachRow(pragma, [&value](const RowCursor& row) {
+            value = row.getInt64(0);
+            return false;
+        });
+        return value;
+    }
+    
+    double probeQueryLatency() {
+        // Calculation - median of a few representative reads, timed without touching query metrics
+        const char* probeSQL = "SELECT COUNT(*) FROM data_records WHERE timestamp >= datetime('now', '-1 day')";
+        vector<double> samples;
+        
+        // Loop - reads on the writer connection must not observe another thread's open transaction
+        for (int i = 0; i < 5; ++i) {
+            lock_guard<recursive_mutex> transactionLock(transactionMutex);
+            sqlite3_stmt* stmt = writerStatements->acquire(probeSQL);
+            if (!stmt) return 0.0;
+            
+            auto start = chrono::high_resolution_clock::now();
+            while (sqlite3_step(stmt) == SQLITE_ROW) {}
+            auto end = chrono::high_resolution_clock::now();
+            writerStatements->release(stmt);
+            
+            samples.push_back(chrono::duration<double, milli>(end - start).count());
+        }
+        
+        sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+    
+    bool createTables() {
+        string createTableSQL = 
+            "CREATE TABLE IF NOT EXISTS data_records ("
+            "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+            "name TEXT NOT NULL,"
+            "value TEXT,"
+            "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP)";
+                 
+        return executeQuery(createTableSQL);
+    }
+    
+    bool migrateSchema() {
+        // Decision making - apply each migration once, tracked through PRAGMA user_version
+        int version = 0;
+        forEachRow("PRAGMA user_version", [&version](const RowCursor& row) {
+            version = static_cast<int>(row.getInt64(0));
+            return false;
+        });
+        
+        // Migration 1 - index timestamps for retention and time-range queries
+        if (version < 1) {
+            if (!executeQuery("CREATE INDEX IF NOT EXISTS idx_data_records_timestamp ON data_records(timestamp)") ||
+                !executeQuery("PRAGMA user_version = 1")) {
+                return false;
+            }
+        }
+        
+        // Migration 2 - incremental auto-vacuum; existing databases need a full VACUUM to switch,
+        // which is too slow for startup, so it stays pending until convertToIncrementalVacuum runs
+        if (version < 2 && pragmaValue("PRAGMA auto_vacuum") == 2) {
+            if (!executeQuery("PRAGMA user_version = 2")) {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    void loadPartitions() {
+        // Loop - rebuild the partition set from the schema
+        set<string> days;
+        forEachRow("SELECT name FROM sqlite_master WHERE type = 'table' AND name GLOB 'data_records_p[0-9]*'",
+                   [&days](const RowCursor& row) {
+            string day = string(row.getText(0)).substr(strlen("data_records_p"));
+            if (day.size() == 8) days.insert(day);
+            return true;
+        });
+        
+        lock_guard<mutex> lock(partitionMutex);
+        partitionDays.swap(days);
+    }
+    
+    // Sample standard deviation; a single sample reports no spread
+    static void meanAndStddev(const vector<double>& samples, double& mean, double& stddev) {
+        mean = 0.0;
+        stddev = 0.0;
+        if (samples.empty()) return;
+        for (double sample : samples) mean += sample;
+        mean /= samples.size();
+        if (samples.size() < 2) return;
+        for (double sample : samples) stddev += (sample - mean) * (sample - mean);
+        stddev = sqrt(stddev / (samples.size() - 1));
+    }
     
-public:
-    DatabaseManager() : db(nullptr), initialized(false), currentConnections(0), 
-                       queryTimeout(30.0), autoCommit(true), totalQueries(0), 
-                       failedQueries(0), averageQueryTime(0.0) {}
+    static string partitionDay(const string& timestamp) {
+        // Decision making - "YYYY-MM-DD..." maps to YYYYMMDD; anything else goes to today's partition
+        bool valid = timestamp.size() >= 10 && timestamp[4] == '-' && timestamp[7] == '-';
+        for (int i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+            if (valid && !isdigit(static_cast<unsigned char>(timestamp[i]))) valid = false;
+        }
+        if (valid) {
+            return timestamp.substr(0, 4) + timestamp.substr(5, 2) + timestamp.substr(8, 2);
+        }
+        
+        time_t now = time(nullptr);
+        tm utc;
+        gmtime_r(&now, &utc);
+        char day[16];
+        strftime(day, sizeof(day), "%Y%m%d", &utc);
+        return day;
+    }
     
-    ~DatabaseManager() {
-        close();
+    static string partitionTable(const string& day) {
+        return "data_records_p" + day;
     }
     
-    bool initialize(const string& dbPath) {
-        // IO call - open database file
-        int result = sqlite3_open(dbPath.c_str(), &db);
-        if (result != SQLITE_OK) {
-            cerr << "Failed to open database: " << sqlite3_errmsg(db) << endl;
+    bool ensurePartition(const string& day) {
+        {
+            lock_guard<mutex> lock(partitionMutex);
+            if (partitionDays.count(day)) return true;
+        }
+        
+        // Service call - same shape as data_records; ids are unique within a partition
+        string table = partitionTable(day);
+        if (!executeQuery("CREATE TABLE IF NOT EXISTS " + table + " ("
+                          "id INTEGER PRIMARY KEY,"
+                          "name TEXT NOT NULL,"
+                          "value TEXT,"
+                          "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP)") ||
+            !executeQuery("CREATE INDEX IF NOT EXISTS idx_" + table + "_timestamp ON " + table + "(timestamp)")) {
             return false;
         }
         
-        // Decision making - enable WAL mode for better performance
-        if (shouldEnableWAL("initialize")) {
-            executeQuery("PRAGMA journal_mode=WAL");
-            executeQuery("PRAGMA synchronous=NORMAL");
+        lock_guard<mutex> lock(partitionMutex);
+        partitionDays.insert(day);
+        return true;
+    }
+    
+    bool prepareStatements() {
+        // Prepare common statements for better performance
+        const char* insertSQL = "INSERT INTO data_records (name, value) VALUES (?, ?)";
+        sqlite3_stmt* stmt;
+        
+        if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, nullptr) == SQLITE_OK) {
+            preparedStatements["insert_data"] = stmt;
         }
         
-        // Create tables
-        if (!createTables()) {
-            return false;
+        // Statements used by batchInsert - one row, and a multi-row VALUES tuple list
+        string recordSQL = "INSERT INTO data_records (name, value, timestamp) VALUES (?, ?, ?)";
+        if (sqlite3_prepare_v2(db, recordSQL.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+            preparedStatements["insert_record"] = stmt;
         }
         
-        // Prepare statements
-        if (!prepareStatements()) {
-            return false;
+        stringstream multiSQL;
+        multiSQL << "INSERT INTO data_records (name, value, timestamp) VALUES (?, ?, ?)";
+        for (size_t i = 1; i < batchInsertRowsPerStatement; ++i) {
+            multiSQL << ", (?, ?, ?)";
+        }
+        if (sqlite3_prepare_v2(db, multiSQL.str().c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
+            preparedStatements["insert_record_multi"] = stmt;
         }
         
-        initialized = true;
-        cout << "Database initialized successfully" << endl;
         return true;
     }
     
-    void close() {
-        if (db) {
-            cleanupStatements();
-            sqlite3_close(db);
-            db = nullptr;
+    // One CSV field, pointing into the mapped file or into a copied quoted value
+    struct CsvField {
+        const char* text;
+        int length;
+    };
+    
+    template <typename Row>
+    bool bindCsvRows(sqlite3_stmt* stmt, const vector<Row>& rows, size_t first, size_t count) {
+        // Loop - bind each field in place; the mapping outlives the step, so SQLITE_STATIC is safe
+        int index = 1;
+        for (size_t r = first; r < first + count; ++r) {
+            for (const auto& field : rows[r]) {
+                sqlite3_bind_text(stmt, index++, field.text, field.length, SQLITE_STATIC);
+            }
         }
-        initialized = false;
+        return stepAndReset(stmt);
     }
     
-    bool executeQuery(const string& query) {
-        if (!initialized || !db) return false;
-        
-        auto start = chrono::high_resolution_clock::now();
-        
-        // Decision making - sanitize query for security
-        string sanitizedQuery = sanitizeQuery(query);
+    bool stepAndReset(sqlite3_stmt* stmt) {
+        int result = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
         
-        char* errorMsg = nullptr;
-        int result = sqlite3_exec(db, sanitizedQuery.c_str(), nullptr, nullptr, &errorMsg);
-        
-        auto end = chrono::high_resolution_clock::now();
-        double queryTime = chrono::duration<double>(end - start).count();
-        
-        bool success = (result == SQLITE_OK);
-        updatePerformanceMetrics(queryTime, success);
-        
-        if (!success && errorMsg) {
-            cerr << "Query failed: " << errorMsg << endl;
-            sqlite3_free(errorMsg);
+        if (result != SQLITE_DONE) {
+            cerr << "Batch insert failed: " << sqlite3_errmsg(db) << endl;
+            return false;
         }
-        
-        return success;
+        return true;
     }
     
-    vector<map<string, string>> selectQuery(const string& query) {
-        vector<map<string, string>> results;
-        if (!initialized || !db) return results;
-        
-        auto start = chrono::high_resolution_clock::now();
-        
-        sqlite3_stmt* stmt;
-        int result = sqlite3_prepare_v2(db, query.c_str(), -1, &stmt, nullptr);
+    static bool parseCsvRecord(const char*& cursor, const char* end, array<CsvField, 3>& fields, int& fieldCount,
+                               deque<string>& quotedFields) {
+        // Loop - RFC 4180 fields; quoted fields may hold commas, "" escapes and line breaks.
+        // fieldCount keeps counting past three so callers can reject extra columns.
+        fieldCount = 0;
+        bool wellFormed = true;
         
-        if (result == SQLITE_OK) {
-            // Loop - process each row
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                map<string, string> row;
-                int columns = sqlite3_column_count(stmt);
+        while (true) {
+            CsvField field{cursor, 0};
+            
+            if (cursor < end && *cursor == '"') {
+                // Quoted field - copied, since the unescaped text differs from the mapping
+                quotedFields.emplace_back();
+                string& value = quotedFields.back();
+                bool closed = false;
+                cursor++;
+                while (cursor < end) {
+                    const char* quote = static_cast<const char*>(memchr(cursor, '"', end - cursor));
+                    if (!quote) {
+                        value.append(cursor, end - cursor);
+                        cursor = end;
+                        break;
+                    }
+                    value.append(cursor, quote - cursor);
+                    cursor = quote + 1;
+                    if (cursor < end && *cursor == '"') {
+                        value += '"';
+                        cursor++;
+                        continue;
+                    }
+                    closed = true;
+                    break;
+                }
                 
-                // Loop - process each column
-                for (int i = 0; i < columns; ++i) {
-                    string columnName = sqlite3_column_name(stmt, i);
-                    const unsigned char* value = sqlite3_column_text(stmt, i);
-                    string columnValue = value ? reinterpret_cast<const char*>(value) : "";
-                    row[columnName] = columnValue;
+                // Decision making - an unterminated quote or text after the closing quote is malformed
+                if (!closed || (cursor < end && *cursor != ',' && *cursor != '\n' && *cursor != '\r')) {
+                    wellFormed = false;
+                }
+                field = {value.data(), static_cast<int>(value.size())};
+            } else {
+                // Unquoted field - bound straight out of the mapping
+                const char* fieldEnd = cursor;
+                while (fieldEnd < end && *fieldEnd != ',' && *fieldEnd != '\n') {
+                    if (*fieldEnd == '"') wellFormed = false;
+                    fieldEnd++;
+                }
+                field = {cursor, static_cast<int>(fieldEnd - cursor)};
+                if ((fieldEnd == end || *fieldEnd == '\n') && field.length > 0 && fieldEnd[-1] == '\r') {
+                    field.length--;
                 }
-                results.push_back(row);
+                cursor = fieldEnd;
             }
+            
+            if (fieldCount < 3) fields[fieldCount] = field;
+            fieldCount++;
+            
+            // Loop - resynchronize on the end of the record after a malformed field
+            while (cursor < end && *cursor != ',' && *cursor != '\n') cursor++;
+            if (cursor >= end) return wellFormed;
+            if (*cursor++ == '\n') return wellFormed;
         }
-        
-        sqlite3_finalize(stmt);
-        
-        auto end = chrono::high_resolution_clock::now();
-        double queryTime = chrono::duration<double>(end - start).count();
-        updatePerformanceMetrics(queryTime, true);
-        
-        return results;
     }
     
-    bool shouldUseConnectionPool() {
-        // Decision making based on current load
-        double connectionEfficiency = calculateConnectionEfficiency();
-        return connectionEfficiency < 0.7 && currentConnections < 10;
+    void profileWrite(sqlite3_stmt* stmt, chrono::high_resolution_clock::time_point start, bool success,
+                      long long rowsAffected) {
+        // Calculation - one profile sample per statement per batch; counters accumulate until recorded
+        if (!queryProfiler) return;
+        double seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        queryProfiler->record(stmt, seconds, success, 0, rowsAffected);
     }
     
-    string selectOptimizationStrategy(const string& query) {
-        // Decision making based on query complexity
-        int complexity = estimateQueryComplexity(query);
+    bool insertRows(sqlite3_stmt* stmt, const vector<const vector<string>*>& rows, size_t first, size_t count) {
+        // Loop - bind name, value, timestamp for each row; the caller keeps rows alive, so SQLITE_STATIC is safe
+        int index = 1;
+        for (size_t r = first; r < first + count; ++r) {
+            const vector<string>& row = *rows[r];
+            for (int column = 0; column < 3; ++column) {
+                sqlite3_bind_text(stmt, index++, row[column].c_str(), static_cast<int>(row[column].size()), SQLITE_STATIC);
+            }
+        }
         
-        if (complexity < 5) {
-            return "simple";
-        } else if (complexity < 15) {
-            return "indexed";
-        } else {
-            return "optimized";
+        return stepAndReset(stmt);
+    }
+    
+    static sqlite3_stmt* bindParams(sqlite3_stmt* stmt, const vector<string>& params) {
+        if (!stmt) return nullptr;
+        
+        // Transient binding - the cursor may outlive the caller's parameter vector
+        for (size_t i = 0; i < params.size(); ++i) {
+            sqlite3_bind_text(stmt, static_cast<int>(i + 1), params[i].c_str(),
+                              static_cast<int>(params[i].size()), SQLITE_TRANSIENT);
         }
+        return stmt;
     }
     
-    bool shouldEnableWAL(const string& operation) {
-        // Decision making - enable WAL for write operations
-        return operation == "initialize" || operation == "batch_insert" || operation == "update";
+    // What the authorizer saw while preparing one statement on the analysis connection
+    struct CapturedReads {
+        set<string> tables;
+        bool volatileFunctions = false; // random(), changes(), current_timestamp, ...
+        bool dateFunctions = false;     // date/time functions, volatile when given 'now'
+    };
+    
+    static CapturedReads*& capturingTables() {
+        // Per-thread target so concurrent prepares on a shared handle never write into another's capture
+        static thread_local CapturedReads* captured = nullptr;
+        return captured;
     }
     
-    double calculateQueryPerformance(const string& query) {
-        // Calculation - estimate performance based on query characteristics
-        int complexity = estimateQueryComplexity(query);
-        double baseTime = complexity * 0.001;
+    static int captureReadTables(void*, int action, const char* table, const char* function, const char*, const char*) {
+        CapturedReads* captured = capturingTables();
+        if (!captured) return SQLITE_OK;
         
-        // Decision making - adjust based on database state
-        if (totalQueries > 1000) {
-            baseTime *= 1.2; // Slight degradation over time
+        if (action == SQLITE_READ && table) {
+            string name(table);
+            transform(name.begin(), name.end(), name.begin(), ::tolower);
+            captured->tables.insert(name);
+        } else if (action == SQLITE_FUNCTION && function) {
+            // Decision making - results that depend on more than the tables read must not be cached
+            string name(function);
+            transform(name.begin(), name.end(), name.begin(), ::tolower);
+            static const set<string> volatileNames = {
+                "random", "randomblob", "changes", "total_changes", "last_insert_rowid",
+                "current_timestamp", "current_date", "current_time"};
+            static const set<string> dateNames = {
+                "date", "time", "datetime", "julianday", "strftime", "unixepoch", "timediff"};
+            if (volatileNames.count(name)) captured->volatileFunctions = true;
+            if (dateNames.count(name)) captured->dateFunctions = true;
         }
-        
-        return baseTime;
+        return SQLITE_OK;
     }
     
-    int estimateQueryComplexity(const string& query) {
-        // Calculation - estimate complexity based on query structure
-        int complexity = 0;
-        
-        // Loop - count different SQL keywords
-        vector<string> keywords = {"SELECT", "FROM", "WHERE", "JOIN", "GROUP BY", "ORDER BY", "HAVING"};
-        for (const auto& keyword : keywords) {
-            if (query.find(keyword) != string::npos) {
-                complexity += 2;
+    bool readTables(const string& query, set<string>& tables) {
+        string key = StatementCache::normalizeSql(query);
+        {
+            lock_guard<mutex> lock(dependencyMutex);
+            auto it = queryDependencies.find(key);
+            if (it != queryDependencies.end()) {
+                tables = it->second.tables;
+                return it->second.cacheable;
             }
         }
         
-        // Decision making - adjust complexity based on query length
-        if (query.length() > 500) {
-            complexity += 5;
-        }
+        // Service call - prepare once on the analysis connection, recording every table the authorizer sees
+        CapturedReads captured;
+        sqlite3_stmt* stmt = nullptr;
+        capturingTables() = &captured;
+        int result = sqlite3_prepare_v2(analysisDb, query.c_str(), -1, &stmt, nullptr);
+        capturingTables() = nullptr;
+        bool readOnly = result == SQLITE_OK && stmt && sqlite3_stmt_readonly(stmt);
+        sqlite3_finalize(stmt);
+        if (result != SQLITE_OK) return false; // not memoized; the schema may not exist yet
         
-        return complexity;
+        // Decision making - only deterministic read-only statements with known dependencies are cacheable
+        string lower = key;
+        transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        bool readsClock = captured.dateFunctions && lower.find("'now'") != string::npos;
+        bool cacheable = readOnly && !captured.tables.empty() && !captured.volatileFunctions && !readsClock;
+        
+        tables = captured.tables;
+        lock_guard<mutex> lock(dependencyMutex);
+        if (queryDependencies.size() >= queryDependencyCapacity) {
+            queryDependencies.clear();
+        }
+        queryDependencies[key] = QueryDependencies{cacheable, move(captured.tables)};
+        return cacheable;
     }
     
-    double calculateConnectionEfficiency() {
-        // Calculation - efficiency based on success rate
-        if (totalQueries == 0) return 1.0;
-        
-        double successRate = static_cast<double>(totalQueries - failedQueries) / totalQueries;
-        double timeEfficiency = max(0.1, 1.0 - averageQueryTime);
+    static bool changesSchema(const string& query) {
+        size_t start = query.find_first_not_of(" \t\r\n");
+        if (start == string::npos) return false;
+        string keyword = query.substr(start, 6);
+        transform(keyword.begin(), keyword.end(), keyword.begin(), ::toupper);
+        return keyword.compare(0, 6, "CREATE") == 0 || keyword.compare(0, 4, "DROP") == 0 ||
+               keyword.compare(0, 5, "ALTER") == 0;
+    }
+    
+    static bool bypassesUpdateHook(const string& query) {
+        string upper = query;
+        transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        size_t start = upper.find_first_not_of(" \t\r\n");
+        if (start == string::npos) return false;
         
-        return (successRate + timeEfficiency) / 2.0;
+        // Decision making - DDL and the truncate optimisation change rows without per-row callbacks
+        if (upper.compare(start, 4, "DROP") == 0 || upper.compare(start, 5, "ALTER") == 0) return true;
+        return upper.compare(start, 6, "DELETE") == 0 && upper.find("WHERE") == string::npos;
     }
     
-    bool batchInsert(const vector<vector<string>>& data) {
-        if (!initialized || data.empty()) return false;
+    static void onRowChange(void* context, int, const char*, const char* table, sqlite3_int64) {
+        DatabaseManager* manager = static_cast<DatabaseManager*>(context);
         
-        // Decision making - use transaction for batch operations
-        executeQuery("BEGIN TRANSACTION");
+        // Decision making - the hooks run serialized on the writer connection, so a table already
+        // marked in this transaction costs one comparison per row and takes no lock
+        vector<string>& seen = manager->tablesChangedInTransaction;
+        if (find(seen.begin(), seen.end(), table) != seen.end()) return;
+        seen.emplace_back(table);
         
-        // Loop - insert each row
-        for (const auto& row : data) {
-            if (row.size() < 3) continue; // Skip invalid rows
-            
-            stringstream ss;
-            ss << "INSERT INTO data_records (name, value, timestamp) VALUES (";
-            ss << "'" << row[0] << "', '" << row[1] << "', '" << row[2] << "')";
-            
-            if (!executeQuery(ss.str())) {
-                executeQuery("ROLLBACK");
-                return false;
-            }
-        }
+        string name(table);
+        transform(name.begin(), name.end(), name.begin(), ::tolower);
         
-        executeQuery("COMMIT");
-        return true;
+        // Drop now so this connection never reads its own stale result, and again at commit
+        manager->resultCache->invalidateTable(name);
+        lock_guard<mutex> lock(manager->dirtyTablesMutex);
+        manager->pendingDirtyTables.insert(name);
     }
     
-    void cleanupOldRecords(int daysOld) {
-        // Calculation - determine cutoff date
-        stringstream ss;
-        ss << "DELETE FROM data_records WHERE timestamp < datetime('now', '-" << daysOld << " days')";
-        
-        // Decision making - use batch deletion for large datasets
-        auto result = selectQuery("SELECT COUNT(*) as count FROM data_records WHERE timestamp < datetime('now', '-" + to_string(daysOld) + " days')");
-        
-        if (!result.empty()) {
-            int count = stoi(result[0]["count"]);
-            if (count > 1000) {
-                // Use batch deletion
-                executeQuery("BEGIN TRANSACTION");
-                executeQuery(ss.str());
-                executeQuery("COMMIT");
-            } else {
-                executeQuery(ss.str());
-            }
-        }
+    static int onCommit(void* context) {
+        // Rollback journal mode has no WAL hook, so invalidate before the commit completes as well
+        DatabaseManager* manager = static_cast<DatabaseManager*>(context);
+        manager->tablesChangedInTransaction.clear();
+        manager->invalidateDirtyTables(false);
+        return 0;
     }
     
-    void optimizeDatabase() {
-        // Service calls - database optimization
-        executeQuery("VACUUM");
-        executeQuery("ANALYZE");
-        executeQuery("REINDEX");
-        
-        // Calculation - update performance metrics
-        averageQueryTime *= 0.9; // Assume 10% improvement
+    static void onRollback(void* context) {
+        DatabaseManager* manager = static_cast<DatabaseManager*>(context);
+        manager->tablesChangedInTransaction.clear();
+        lock_guard<mutex> lock(manager->dirtyTablesMutex);
+        manager->pendingDirtyTables.clear();
     }
     
-    bool backupDatabase(const string& backupPath) {
-        if (!initialized) return false;
+    static int onWalCommit(void* context, sqlite3* handle, const char* database, int frames) {
+        DatabaseManager* manager = static_cast<DatabaseManager*>(context);
+        manager->walFrames = frames;
+        manager->walCommits++;
         
-        // IO call - create backup file
-        ofstream backupFile(backupPath);
-        if (!backupFile.is_open()) {
-            return false;
+        // The commit is now visible to readers; results cached in the meantime are discarded
+        if (manager->resultCache) {
+            manager->invalidateDirtyTables(true);
         }
         
-        // Service call - backup database
-        sqlite3* backupDb;
-        int result = sqlite3_open(backupPath.c_str(), &backupDb);
-        if (result != SQLITE_OK) {
-            return false;
+        // Decision making - the checkpointer thread owns checkpoints; nudge it once the WAL is large
+        if (manager->backgroundCheckpointing) {
+            if (frames >= manager->checkpointPassiveFrames) {
+                manager->checkpointWake.notify_one();
+            }
+            return SQLITE_OK;
         }
         
-        sqlite3_backup* backup = sqlite3_backup_init(backupDb, "main", db, "main");
-        if (backup) {
-            sqlite3_backup_step(backup, -1);
-            sqlite3_backup_finish(backup);
+        // Registering a WAL hook replaces auto-checkpointing, so apply the profile's threshold here
+        if (manager->walAutocheckpointFrames > 0 && frames >= manager->walAutocheckpointFrames) {
+            sqlite3_wal_checkpoint_v2(handle, database, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
         }
-        
-        sqlite3_close(backupDb);
-        return true;
-    }
-    
-    bool validateDatabaseIntegrity() {
-        // Service call - integrity check
-        auto result = selectQuery("PRAGMA integrity_check");
-        return !result.empty() && result[0]["integrity_check"] == "ok";
+        return SQLITE_OK;
     }
     
-private:
-    bool createTables() {
-        string createTableSQL = 
-            "CREATE TABLE IF NOT EXISTS data_records ("
-            "id INTEGER PRIMARY KEY AUTOINCREMENT,"
-            "name TEXT NOT NULL,"
-            "value TEXT,"
-            "timestamp DATETIME DEFAULT CURRENT_TIMESTAMP)";
-                 
-        return executeQuery(createTableSQL);
+    void runCheckpointer(long long restartFrames, chrono::milliseconds idleThreshold, chrono::milliseconds checkInterval) {
+        long long commitsCheckpointed = -1;
+        unique_lock<mutex> lock(checkpointMutex);
+        
+        // Loop - checkpoint when the WAL grows past a threshold or the writer goes quiet
+        while (checkpointerRunning) {
+            checkpointWake.wait_for(lock, checkInterval);
+            if (!checkpointerRunning) break;
+            
+            long long commits = walCommits.load();
+            if (commits == commitsCheckpointed) continue; // nothing written since the last complete checkpoint
+            
+            long long frames = walFrames.load();
+            auto idleFor = chrono::steady_clock::now().time_since_epoch() -
+                           chrono::steady_clock::duration(lastActivity.load());
+            
+            // Decision making - RESTART rewinds an oversized WAL; PASSIVE never blocks the writer
+            int mode;
+            if (frames >= restartFrames) {
+                mode = SQLITE_CHECKPOINT_RESTART;
+            } else if (frames >= checkpointPassiveFrames || idleFor >= idleThreshold) {
+                mode = SQLITE_CHECKPOINT_PASSIVE;
+            } else {
+                continue;
+            }
+            
+            lock.unlock();
+            int logFrames = 0, checkpointedFrames = 0;
+            auto start = chrono::high_resolution_clock::now();
+            int result = sqlite3_wal_checkpoint_v2(checkpointDb, nullptr, mode, &logFrames, &checkpointedFrames);
+            auto end = chrono::high_resolution_clock::now();
+            double milliseconds = chrono::duration<double, milli>(end - start).count();
+            lock.lock();
+            
+            if (result == SQLITE_OK && logFrames >= 0 && checkpointedFrames == logFrames) {
+                commitsCheckpointed = commits;
+            }
+            
+            // Calculation - checkpoint counters and durations
+            lock_guard<mutex> metricsLock(metricsMutex);
+            checkpointStats[mode == SQLITE_CHECKPOINT_RESTART ? "checkpoint_restart_count" : "checkpoint_passive_count"]++;
+            if (result == SQLITE_BUSY) checkpointStats["checkpoint_busy_count"]++;
+            checkpointStats["checkpoint_last_ms"] = milliseconds;
+            checkpointStats["checkpoint_total_ms"] += milliseconds;
+            checkpointStats["checkpoint_max_ms"] = max(checkpointStats["checkpoint_max_ms"], milliseconds);
+            checkpointStats["checkpoint_last_frames"] = checkpointedFrames;
+        }
     }
     
-    bool prepareStatements() {
-        // Prepare common statements for better performance
-        const char* insertSQL = "INSERT INTO data_records (name, value) VALUES (?, ?)";
-        sqlite3_stmt* stmt;
-        
-        if (sqlite3_prepare_v2(db, insertSQL, -1, &stmt, nullptr) == SQLITE_OK) {
-            preparedStatements["insert_data"] = stmt;
+    void invalidateDirtyTables(bool committed) {
+        set<string> tables;
+        {
+            lock_guard<mutex> lock(dirtyTablesMutex);
+            if (committed) {
+                tables.swap(committingTables);
+            } else {
+                tables.swap(pendingDirtyTables);
+                committingTables = tables;
+            }
+        }
+        for (const auto& table : tables) {
+            resultCache->invalidateTable(table);
         }
-        
-        return true;
     }
     
     void cleanupStatements() {
@@ -318,6 +3251,11 @@ private:
     }
     
     void updatePerformanceMetrics(double queryTime, bool success) {
+        // The maintenance scheduler treats any recorded query as activity
+        lastActivity = chrono::steady_clock::now().time_since_epoch().count();
+        
+        // Pooled readers report from several threads at once
+        lock_guard<mutex> lock(metricsMutex);
         totalQueries++;
         if (!success) failedQueries++;
         
@@ -373,18 +3311,162 @@ int main() {
         cout << "Batch insert failed" << endl;
     }
     
+    // Insert processed results through the prepared statement in one transaction
+    vector<vector<string>> processedRows = {
+        {"PROCESSED ITEM 1", "processed"},
+        {"PROCESSED ITEM 2", "processed"},
+        {"PROCESSED ITEM 3", "processed"}
+    };
+    
+    if (dbManager.executePreparedBatch("insert_data", processedRows)) {
+        cout << "Prepared batch insert completed successfully" << endl;
+    } else {
+        cout << "Prepared batch insert failed" << endl;
+    }
+    
+    // Measure bulk insert throughput
+    cout << "\n--- Bulk Insert Throughput ---" << endl;
+    vector<vector<string>> bulkData;
+    bulkData.reserve(100000);
+    for (int i = 0; i < 100000; ++i) {
+        bulkData.push_back({"Bulk" + to_string(i), "Value" + to_string(i), "2023-06-01 00:00:00"});
+    }
+    
+    if (dbManager.batchInsert(bulkData)) {
+        cout << "Inserted " << bulkData.size() << " rows at " << static_cast<long long>(dbManager.lastBatchRowsPerSecond) << " rows/sec" << endl;
+    }
+    dbManager.executeQuery("DELETE FROM data_records WHERE name LIKE 'Bulk%'");
+    
+    // Bulk-load a CSV file straight from a memory mapping
+    cout << "\n--- Bulk CSV Import ---" << endl;
+    {
+        ofstream csv("bulk_import.csv");
+        csv << "name,value,timestamp\n";
+        for (int i = 0; i < 100000; ++i) {
+            csv << "Csv" << i << ",\"Value, " << i << "\",2023-08-01 00:00:00\n";
+        }
+    }
+    auto importReport = dbManager.bulkImportCsv("bulk_import.csv");
+    cout << "Imported " << importReport["rows"] << " rows at " << static_cast<long long>(importReport["rows_per_second"])
+         << " rows/sec, rebuilt " << importReport["indexes_rebuilt"] << " indexes" << endl;
+    dbManager.executeQuery("DELETE FROM data_records WHERE name LIKE 'Csv%'");
+    remove("bulk_import.csv");
+    
     // Query the data
     cout << "\n--- Querying Data ---" << endl;
     auto results = dbManager.selectQuery("SELECT * FROM data_records ORDER BY id");
     
     cout << "Retrieved " << results.size() << " records:" << endl;
-    for (const auto& row : results) {
+    for (auto& row : results) {
         cout << "ID: " << row["id"] 
              << ", Name: " << row["name"] 
              << ", Value: " << row["value"] 
              << ", Timestamp: " << row["timestamp"] << endl;
     }
     
+    // Asynchronous inserts acknowledged after group commit
+    cout << "\n--- Async Writer ---" << endl;
+    dbManager.startAsyncWriter(128, chrono::milliseconds(5));
+    vector<future<bool>> acknowledgements;
+    for (int i = 0; i < 1000; ++i) {
+        acknowledgements.push_back(dbManager.asyncInsert("Async" + to_string(i), "Value" + to_string(i), "2023-07-01 00:00:00"));
+    }
+    
+    int durableCount = 0;
+    for (auto& ack : acknowledgements) {
+        if (ack.get()) durableCount++;
+    }
+    dbManager.stopAsyncWriter();
+    cout << "Durable async writes: " << durableCount << "/" << acknowledgements.size()
+         << " in " << dbManager.asyncCommits << " commits" << endl;
+    dbManager.executeQuery("DELETE FROM data_records WHERE name LIKE 'Async%'");
+    
+    // Checkpoints move off the commit path onto a background thread
+    cout << "\n--- WAL Checkpointing ---" << endl;
+    if (dbManager.startCheckpointer(500, 5000, chrono::milliseconds(100), chrono::milliseconds(20))) {
+        for (int i = 0; i < 200; ++i) {
+            dbManager.executePreparedQuery("insert_record", {"Wal" + to_string(i), string(512, 'w'), "2023-08-01 00:00:00"});
+        }
+        this_thread::sleep_for(chrono::milliseconds(300));
+        
+        auto checkpointStats = dbManager.getCheckpointStats();
+        cout << "WAL frames: " << checkpointStats["wal_frames"] << " (" << checkpointStats["wal_file_bytes"] / 1024 << " KiB on disk)"
+             << ", passive: " << checkpointStats["checkpoint_passive_count"]
+             << ", restart: " << checkpointStats["checkpoint_restart_count"]
+             << ", max duration: " << checkpointStats["checkpoint_max_ms"] << " ms" << endl;
+        dbManager.executeQuery("DELETE FROM data_records WHERE name LIKE 'Wal%'");
+    }
+    
+    // Stream rows through a cursor without materializing the result set
+    cout << "\n--- Row Cursor ---" << endl;
+    int64_t idSum = 0;
+    size_t nameBytes = 0;
+    dbManager.forEachRow("SELECT id, name FROM data_records", [&idSum, &nameBytes](const RowCursor& row) {
+        idSum += row.getInt64(0);
+        nameBytes += row.getText(1).size();
+        return true;
+    });
+    cout << "Sum of ids: " << idSum << ", total name bytes: " << nameBytes << endl;
+    
+    // Repeated queries are served from the statement cache
+    cout << "\n--- Statement Cache ---" << endl;
+    for (int i = 0; i < 10; ++i) {
+        dbManager.selectQuery("SELECT COUNT(*) AS count FROM data_records");
+    }
+    auto cacheStats = dbManager.getStatementCacheStats();
+    cout << "Statement cache hits: " << cacheStats["statement_cache_hits"]
+         << ", misses: " << cacheStats["statement_cache_misses"]
+         << ", cached: " << cacheStats["statement_cache_size"] << endl;
+    
+    // Profile queries through their real plans and execution counters
+    cout << "\n--- Query Profiling ---" << endl;
+    dbManager.enableQueryProfiling(0.0005);
+    dbManager.selectQuery("SELECT * FROM data_records WHERE name = 'User1'");
+    dbManager.selectQuery("SELECT * FROM data_records WHERE timestamp > '2024-01-01' ORDER BY name");
+    dbManager.selectQuery("SELECT * FROM data_records WHERE id = 3");
+    
+    for (const auto& profile : dbManager.getQueryProfiles()) {
+        if (profile.plan.empty()) continue;
+        cout << profile.sql << endl;
+        cout << "  Plan: " << profile.plan << endl;
+        cout << "  Full scan: " << (profile.fullTableScan ? "Yes" : "No")
+             << ", missing index: " << (profile.missingIndex ? "Yes" : "No")
+             << ", full-scan steps: " << profile.fullScanSteps
+             << ", VM steps: " << profile.vmSteps << endl;
+    }
+    cout << "Slow queries logged: " << dbManager.getSlowQueries().size() << endl;
+    
+    // Per-fingerprint latency histograms
+    for (int i = 1; i <= 20; ++i) {
+        dbManager.selectQuery("SELECT * FROM data_records WHERE id = " + to_string(i));
+    }
+    for (const auto& stats : dbManager.getQueryLatencyStats()) {
+        if (stats.fingerprint.find("id = ?") == string::npos) continue;
+        cout << stats.fingerprint << ": " << stats.latency.count << " runs, p50 "
+             << stats.latency.percentile(0.5) * 1e6 << " us, p99 " << stats.latency.percentile(0.99) * 1e6
+             << " us, rows " << stats.rowsReturned << endl;
+    }
+    if (dbManager.dumpQueryStatsJson("query_stats.json")) {
+        cout << "Query statistics written to query_stats.json" << endl;
+    }
+    
+    // Repeated reads are served from the result cache until a write touches their tables
+    cout << "\n--- Query Result Cache ---" << endl;
+    if (dbManager.enableQueryCache(16 * 1024 * 1024, chrono::milliseconds(30000))) {
+        string countQuery = "SELECT COUNT(*) AS count FROM data_records WHERE name = ?";
+        for (int i = 0; i < 5; ++i) {
+            dbManager.selectQuery(countQuery, {"User1"});
+        }
+        dbManager.executePreparedQuery("insert_record", {"User1", "cached", "2024-06-01 00:00:00"});
+        auto refreshed = dbManager.selectQuery(countQuery, {"User1"});
+        
+        auto resultCacheStats = dbManager.getQueryCacheStats();
+        cout << "Count after insert: " << (refreshed.empty() ? "n/a" : refreshed[0]["count"]) << endl;
+        cout << "Result cache hits: " << resultCacheStats["result_cache_hits"]
+             << ", misses: " << resultCacheStats["result_cache_misses"]
+             << ", invalidations: " << resultCacheStats["result_cache_invalidations"] << endl;
+    }
+    
     // Test query optimization
     cout << "\n--- Query Optimization ---" << endl;
     string testQuery = "SELECT * FROM data_records WHERE name LIKE '%User%' ORDER BY timestamp";
@@ -403,10 +3485,54 @@ int main() {
     bool shouldUsePool = dbManager.shouldUseConnectionPool();
     cout << "Should use connection pool: " << (shouldUsePool ? "Yes" : "No") << endl;
     
+    // Test concurrent reads through the connection pool
+    cout << "\n--- Connection Pool ---" << endl;
+    if (dbManager.enableConnectionPool(4)) {
+        vector<thread> readers;
+        vector<size_t> rowCounts(4, 0);
+        
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&dbManager, &rowCounts, i]() {
+                for (int j = 0; j < 50; ++j) {
+                    rowCounts[i] += dbManager.selectQuery("SELECT * FROM data_records ORDER BY id").size();
+                }
+            });
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        
+        auto poolStats = dbManager.readerPool.getStats();
+        cout << "Pooled readers: " << poolStats["pool_readers"] << ", checkouts: " << poolStats["pool_checkouts"]
+             << ", waits: " << poolStats["pool_waits"] << endl;
+        cout << "Rows read per thread: " << rowCounts[0] << endl;
+    }
+    
+    // Measure each PRAGMA profile on this machine and pick one per workload
+    cout << "\n--- PRAGMA Profiles ---" << endl;
+    auto profileResults = dbManager.benchmarkPragmaProfiles();
+    for (const auto& result : profileResults) {
+        cout << result.profile << ": " << static_cast<long long>(result.insertRowsPerSecond) << " +/- "
+             << static_cast<long long>(result.insertStddev) << " inserts/sec, "
+             << static_cast<long long>(result.selectsPerSecond) << " +/- "
+             << static_cast<long long>(result.selectStddev) << " selects/sec" << endl;
+    }
+    string writeHeavy = dbManager.recommendPragmaProfile(profileResults, 0.01);
+    string readHeavy = dbManager.recommendPragmaProfile(profileResults, 0.9);
+    cout << "Recommended for 1% reads: " << (writeHeavy.empty() ? "no significant difference" : writeHeavy)
+         << ", for 90% reads: " << (readHeavy.empty() ? "no significant difference" : readHeavy) << endl;
+    
     // Test database optimization
     cout << "\n--- Database Optimization ---" << endl;
-    dbManager.optimizeDatabase();
-    cout << "Database optimization completed" << endl;
+    auto maintenance = dbManager.optimizeDatabase();
+    cout << "Database optimization completed: freed " << maintenance["pages_freed"] << " pages, probe "
+         << maintenance["probe_before_ms"] << " ms -> " << maintenance["probe_after_ms"] << " ms" << endl;
+    
+    // Scheduled maintenance runs once the database has been idle
+    dbManager.startMaintenanceScheduler(chrono::milliseconds(50), chrono::milliseconds(20), chrono::milliseconds(100));
+    this_thread::sleep_for(chrono::milliseconds(200));
+    dbManager.stopMaintenanceScheduler();
+    cout << "Idle maintenance report: " << dbManager.getLastMaintenanceReport()["elapsed_ms"] << " ms" << endl;
     
     // Test database integrity
     cout << "\n--- Database Integrity ---" << endl;
@@ -419,16 +3545,39 @@ int main() {
     // Test backup functionality
     cout << "\n--- Database Backup ---" << endl;
     string backupPath = "backup_database.db";
-    if (dbManager.backupDatabase(backupPath)) {
+    auto backupDone = dbManager.backupDatabaseAsync(backupPath, 64, chrono::milliseconds(1),
+        [](int remaining, int total) {
+            cout << "Backup progress: " << (total - remaining) << "/" << total << " pages" << endl;
+        });
+    if (backupDone.get()) {
         cout << "Database backup created successfully" << endl;
     } else {
         cout << "Database backup failed" << endl;
     }
     
     // Test cleanup operations
+    cout << "\n--- Time Partitions ---" << endl;
+    if (dbManager.enablePartitioning()) {
+        vector<vector<string>> events;
+        for (int i = 0; i < 3000; ++i) {
+            int day = 1 + i % 30;
+            events.push_back({"Event" + to_string(i), "Payload" + to_string(i),
+                              string("2020-03-") + (day < 10 ? "0" : "") + to_string(day) + " 12:00:00"});
+        }
+        if (dbManager.insertPartitioned(events)) {
+            cout << "Partitions: " << dbManager.getPartitions().size() << endl;
+        }
+        
+        auto week = dbManager.selectTimeRange("2020-03-10 00:00:00", "2020-03-17 00:00:00", "COUNT(*) AS count");
+        cout << "Rows in one week (8 partitions scanned): " << (week.empty() ? "n/a" : week[0]["count"]) << endl;
+        
+        int dropped = dbManager.dropPartitionsOlderThan(365);
+        cout << "Dropped " << dropped << " expired partitions, " << dbManager.getPartitions().size() << " remain" << endl;
+    }
+    
     cout << "\n--- Cleanup Operations ---" << endl;
-    dbManager.cleanupOldRecords(365); // Clean records older than 1 year
-    cout << "Old records cleanup completed" << endl;
+    long long removed = dbManager.cleanupOldRecords(365); // Clean records older than 1 year
+    cout << "Old records cleanup completed, removed " << removed << " records" << endl;
     
     // Test WAL mode decision
     cout << "\n--- WAL Mode Analysis ---" << endl;
@@ -7,13 +7,576 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <deque>
 #include <memory>
+#include <sstream>
+#include <numeric>
+#include <cmath>
+#include <list>
+#include <unordered_map>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
 
 using namespace std;
 
 // Forward declaration
 class DatabaseManager;
 
+// Result cache class for memoizing processItem outcomes keyed by (mode, input hash)
+class ResultCache {
+public:
+    struct Entry {
+        string transformed;
+        string strategy;
+        bool success;
+        bool valid;        // false when the input was rejected by validation
+    };
+    
+private:
+    struct Node {
+        size_t key;
+        string mode;
+        string input;
+        Entry entry;
+        size_t bytes;
+    };
+    
+    struct Shard {
+        mutex shardMutex;
+        list<Node> lru;
+        unordered_map<size_t, list<Node>::iterator> index;
+        size_t bytes = 0;
+    };
+    
+    static const size_t shardCount = 16;
+    Shard shards[shardCount];
+    size_t shardBudget;
+    
+    // Calculation variables
+    atomic<long long> hits;
+    atomic<long long> misses;
+    atomic<long long> evictions;
+    
+public:
+    explicit ResultCache(size_t memoryBudgetBytes)
+        : shardBudget(max<size_t>(memoryBudgetBytes / shardCount, 1)),
+          hits(0), misses(0), evictions(0) {}
+    
+    bool lookup(const string& mode, const string& input, Entry& out) {
+        size_t key = makeKey(mode, input);
+        Shard& shard = shards[key % shardCount];
+        lock_guard<mutex> lock(shard.shardMutex);
+        
+        // Decision making - a matching hash must also match the stored input
+        auto it = shard.index.find(key);
+        if (it == shard.index.end() || it->second->mode != mode || it->second->input != input) {
+            misses++;
+            return false;
+        }
+        
+        // Move to front - most recently used
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        out = it->second->entry;
+        hits++;
+        return true;
+    }
+    
+    void insert(const string& mode, const string& input, const Entry& entry) {
+        size_t key = makeKey(mode, input);
+        size_t bytes = sizeof(Node) + mode.capacity() + input.capacity() +
+                       entry.transformed.capacity() + entry.strategy.capacity() +
+                       2 * sizeof(void*) + sizeof(size_t); // list + hash node overhead
+        
+        // Decision making - entries larger than a shard budget are never cached
+        if (bytes > shardBudget) return;
+        
+        Shard& shard = shards[key % shardCount];
+        lock_guard<mutex> lock(shard.shardMutex);
+        
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.bytes -= it->second->bytes;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+        
+        shard.lru.push_front(Node{key, mode, input, entry, bytes});
+        shard.index[key] = shard.lru.begin();
+        shard.bytes += bytes;
+        
+        // Loop - evict least recently used entries until within budget
+        while (shard.bytes > shardBudget && !shard.lru.empty()) {
+            Node& victim = shard.lru.back();
+            shard.bytes -= victim.bytes;
+            shard.index.erase(victim.key);
+            shard.lru.pop_back();
+            evictions++;
+        }
+    }
+    
+    void clear() {
+        for (auto& shard : shards) {
+            lock_guard<mutex> lock(shard.shardMutex);
+            shard.lru.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+    
+    map<string, double> getStats() {
+        size_t entries = 0, bytes = 0;
+        for (auto& shard : shards) {
+            lock_guard<mutex> lock(shard.shardMutex);
+            entries += shard.lru.size();
+            bytes += shard.bytes;
+        }
+        
+        long long hitCount = hits.load();
+        long long missCount = misses.load();
+        long long lookups = hitCount + missCount;
+        
+        map<string, double> stats;
+        stats["cache_hits"] = static_cast<double>(hitCount);
+        stats["cache_misses"] = static_cast<double>(missCount);
+        stats["cache_hit_rate"] = lookups > 0 ? static_cast<double>(hitCount) / lookups : 0.0;
+        stats["cache_evictions"] = static_cast<double>(evictions.load());
+        stats["cache_entries"] = static_cast<double>(entries);
+        stats["cache_bytes"] = static_cast<double>(bytes);
+        stats["cache_budget_bytes"] = static_cast<double>(shardBudget * shardCount);
+        return stats;
+    }
+    
+private:
+    static size_t makeKey(const string& mode, const string& input) {
+        // Calculation - combine mode and input hashes
+        size_t h = hash<string>{}(input);
+        h ^= hash<string>{}(mode) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// Result stream class - bounded ring buffer delivering results to a consumer as they are produced
+class ResultStream {
+private:
+    vector<string> slots;
+    size_t head;
+    size_t tail;
+    size_t count;
+    bool closed;
+    mutex streamMutex;
+    condition_variable notEmpty;
+    condition_variable notFull;
+    
+    // Calculation variables
+    long long published;
+    long long producerWaits;
+    
+public:
+    explicit ResultStream(size_t capacity) : slots(max<size_t>(capacity, 1)), head(0), tail(0),
+                                             count(0), closed(false), published(0), producerWaits(0) {}
+    
+    bool push(const string& result) {
+        unique_lock<mutex> lock(streamMutex);
+        
+        // Decision making - apply backpressure while the consumer is behind
+        if (count == slots.size() && !closed) {
+            producerWaits++;
+            notFull.wait(lock, [this]() { return count < slots.size() || closed; });
+        }
+        if (closed) return false;
+        
+        // Slot strings keep their capacity, so steady-state pushes do not allocate
+        slots[tail].assign(result);
+        tail = (tail + 1) % slots.size();
+        count++;
+        published++;
+        
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+    
+    bool pop(string& out, chrono::microseconds timeout) {
+        unique_lock<mutex> lock(streamMutex);
+        if (!notEmpty.wait_for(lock, timeout, [this]() { return count > 0 || closed; })) {
+            return false;
+        }
+        return takeFront(lock, out);
+    }
+    
+    bool pop(string& out) {
+        unique_lock<mutex> lock(streamMutex);
+        notEmpty.wait(lock, [this]() { return count > 0 || closed; });
+        return takeFront(lock, out);
+    }
+    
+    bool tryPop(string& out) {
+        unique_lock<mutex> lock(streamMutex);
+        return takeFront(lock, out);
+    }
+    
+    void close() {
+        {
+            lock_guard<mutex> lock(streamMutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+    
+    bool isClosed() {
+        lock_guard<mutex> lock(streamMutex);
+        return closed;
+    }
+    
+    map<string, double> getStats() {
+        lock_guard<mutex> lock(streamMutex);
+        map<string, double> stats;
+        stats["capacity"] = static_cast<double>(slots.size());
+        stats["pending"] = static_cast<double>(count);
+        stats["published"] = static_cast<double>(published);
+        stats["producer_waits"] = static_cast<double>(producerWaits);
+        return stats;
+    }
+    
+private:
+    bool takeFront(unique_lock<mutex>& lock, string& out) {
+        // Decision making - a closed stream still drains buffered results
+        if (count == 0) return false;
+        
+        // Swap hands the buffer to the consumer and recycles the consumer's old one
+        out.swap(slots[head]);
+        head = (head + 1) % slots.size();
+        count--;
+        
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+};
+
+// Adaptive controller class - re-tunes strategy threshold and validation from measured cost
+class AdaptiveController {
+private:
+    struct StrategyStats {
+        double latency = 0.0;     // EWMA seconds per execution
+        double successRate = 1.0; // EWMA of successful executions
+        long long samples = 0;
+    };
+    
+    mutex controllerMutex;
+    map<string, StrategyStats> strategyStats;
+    
+    // Decision making variables
+    double latencySlo;
+    int baseThreshold;
+    int complexityThreshold;
+    bool validationEnabled;
+    
+    // Calculation variables
+    double validationCost;
+    double failureRate;        // executions that failed plus inputs validation rejected
+    double failureCost;
+    long long samplesSinceRetune;
+    long long retunesSinceValidationChange;
+    long long retunes;
+    
+    static constexpr double smoothing = 0.1;
+    static constexpr int retuneInterval = 32;
+    static constexpr int thresholdStep = 5;
+    static constexpr int maxThreshold = 200;
+    
+    // Hysteresis - validation turns on above one failure rate, off only below a lower one,
+    // and holds each setting for a minimum number of retunes
+    static constexpr double validationOnFailureRate = 0.1;
+    static constexpr double validationOffFailureRate = 0.02;
+    static constexpr int minValidationDwell = 4;
+    
+public:
+    AdaptiveController(double latencySloSeconds, int initialThreshold, bool initialValidation)
+        : latencySlo(latencySloSeconds), baseThreshold(initialThreshold),
+          complexityThreshold(initialThreshold), validationEnabled(initialValidation),
+          validationCost(0.0), failureRate(0.0), failureCost(0.0), samplesSinceRetune(0),
+          retunesSinceValidationChange(0), retunes(0) {}
+    
+    void recordValidation(double seconds) {
+        lock_guard<mutex> lock(controllerMutex);
+        validationCost = ewma(validationCost, seconds);
+    }
+    
+    void recordRejection() {
+        lock_guard<mutex> lock(controllerMutex);
+        
+        // Calculation - a rejected input would have failed without validation, so it keeps the
+        // failure signal alive while validation is filtering it out
+        failureRate = ewma(failureRate, 1.0);
+        if (++samplesSinceRetune >= retuneInterval) {
+            retune();
+        }
+    }
+    
+    void recordExecution(const string& strategy, double seconds, bool success) {
+        lock_guard<mutex> lock(controllerMutex);
+        StrategyStats& stats = strategyStats[strategy];
+        stats.latency = stats.samples == 0 ? seconds : ewma(stats.latency, seconds);
+        stats.successRate = ewma(stats.successRate, success ? 1.0 : 0.0);
+        stats.samples++;
+        
+        // Calculation - failures cost the full retry loop, which validation could have avoided
+        failureRate = ewma(failureRate, success ? 0.0 : 1.0);
+        if (!success) {
+            failureCost = failureCost == 0.0 ? seconds : ewma(failureCost, seconds);
+        }
+        
+        if (++samplesSinceRetune >= retuneInterval) {
+            retune();
+        }
+    }
+    
+    int getComplexityThreshold() {
+        lock_guard<mutex> lock(controllerMutex);
+        return complexityThreshold;
+    }
+    
+    bool shouldValidate() {
+        lock_guard<mutex> lock(controllerMutex);
+        return validationEnabled;
+    }
+    
+    map<string, double> getMetrics() {
+        lock_guard<mutex> lock(controllerMutex);
+        map<string, double> metrics;
+        metrics["adaptive_latency_slo"] = latencySlo;
+        metrics["adaptive_complexity_threshold"] = complexityThreshold;
+        metrics["adaptive_validation"] = validationEnabled ? 1.0 : 0.0;
+        metrics["adaptive_validation_cost"] = validationCost;
+        metrics["adaptive_failure_rate"] = failureRate;
+        metrics["adaptive_retunes"] = static_cast<double>(retunes);
+        
+        // Loop - per-strategy measurements
+        for (const auto& entry : strategyStats) {
+            metrics["strategy_" + entry.first + "_latency"] = entry.second.latency;
+            metrics["strategy_" + entry.first + "_success_rate"] = entry.second.successRate;
+            metrics["strategy_" + entry.first + "_samples"] = static_cast<double>(entry.second.samples);
+        }
+        return metrics;
+    }
+    
+private:
+    static double ewma(double current, double sample) {
+        return current + smoothing * (sample - current);
+    }
+    
+    void retune() {
+        samplesSinceRetune = 0;
+        retunes++;
+        
+        // Decision making - route more items to "standard" while "advanced" misses the SLO
+        auto standard = strategyStats.find("standard");
+        auto advanced = strategyStats.find("advanced");
+        if (standard != strategyStats.end() && advanced != strategyStats.end()) {
+            bool advancedSlow = advanced->second.latency > latencySlo;
+            bool standardFits = standard->second.latency <= latencySlo &&
+                                standard->second.successRate + 0.05 >= advanced->second.successRate;
+            
+            if (advancedSlow && standardFits) {
+                complexityThreshold = min(maxThreshold, complexityThreshold + thresholdStep);
+            } else if (advanced->second.latency <= latencySlo * 0.5) {
+                complexityThreshold = max(baseThreshold, complexityThreshold - thresholdStep);
+            }
+        }
+        
+        // Decision making - validate when the expected cost of failed items exceeds the cost of checking
+        double expectedFailureCost = failureRate * failureCost;
+        if (++retunesSinceValidationChange < minValidationDwell) return;
+        if (!validationEnabled && (failureRate > validationOnFailureRate || expectedFailureCost > validationCost)) {
+            validationEnabled = true;
+            retunesSinceValidationChange = 0;
+        } else if (validationEnabled && failureRate < validationOffFailureRate &&
+                   expectedFailureCost < validationCost * 0.5) {
+            validationEnabled = false;
+            retunesSinceValidationChange = 0;
+        }
+    }
+};
+
+// Write-behind buffer class - accumulates rows and flushes them in batches on a background thread
+class WriteBehindBuffer {
+private:
+    function<bool(const vector<vector<string>>&)> flushBatch;
+    function<void(const vector<vector<string>>&)> errorHandler;
+    size_t maxRows;
+    chrono::milliseconds maxDelay;
+    
+    deque<vector<string>> pending;
+    mutex bufferMutex;
+    mutex writeMutex;
+    condition_variable flushNeeded;
+    condition_variable spaceAvailable;
+    bool stopping;
+    thread writer;
+    
+    // Decision making variables - failed batches back off exponentially and are
+    // dropped after maxAttempts consecutive failures
+    int consecutiveFailures;
+    chrono::steady_clock::time_point retryAt;
+    static constexpr int maxAttempts = 5;
+    static constexpr chrono::milliseconds baseBackoff{50};
+    static constexpr chrono::milliseconds maxBackoff{5000};
+    
+    // Calculation variables
+    long long rowsWritten;
+    long long batchesWritten;
+    long long failedBatches;
+    long long droppedRows;
+    
+public:
+    WriteBehindBuffer(function<bool(const vector<vector<string>>&)> sink, size_t batchRows,
+                      chrono::milliseconds flushInterval)
+        : flushBatch(move(sink)), maxRows(max<size_t>(batchRows, 1)), maxDelay(flushInterval),
+          stopping(false), consecutiveFailures(0), rowsWritten(0), batchesWritten(0),
+          failedBatches(0), droppedRows(0) {
+        writer = thread(&WriteBehindBuffer::run, this);
+    }
+    
+    ~WriteBehindBuffer() {
+        {
+            lock_guard<mutex> lock(bufferMutex);
+            stopping = true;
+        }
+        flushNeeded.notify_one();
+        spaceAvailable.notify_all();
+        writer.join();
+        
+        // Final drain - one attempt per batch so shutdown never waits out a backoff
+        while (writeNextBatch(true)) {}
+    }
+    
+    void setErrorHandler(function<void(const vector<vector<string>>&)> handler) {
+        // Service call - receives each batch that is dropped after exhausting its retries
+        lock_guard<mutex> writeLock(writeMutex);
+        errorHandler = move(handler);
+    }
+    
+    // Returns false when the row was shed because the sink is failing
+    bool enqueue(vector<string> row) {
+        bool full;
+        {
+            unique_lock<mutex> lock(bufferMutex);
+            
+            // Decision making - a full backlog blocks the producer while the sink keeps up,
+            // and sheds rows only while a batch is failing
+            while (pending.size() >= maxRows * 10 && !stopping) {
+                if (consecutiveFailures > 0) {
+                    droppedRows++;
+                    return false;
+                }
+                flushNeeded.notify_one();
+                spaceAvailable.wait(lock);
+            }
+            pending.push_back(move(row));
+            full = pending.size() >= maxRows;
+        }
+        
+        // Decision making - wake the writer early once a full batch is ready
+        if (full) {
+            flushNeeded.notify_one();
+        }
+        return true;
+    }
+    
+    void flush() {
+        // Loop - write everything pending in batches of at most maxRows
+        while (writeNextBatch(false)) {}
+    }
+    
+    map<string, double> getStats() {
+        lock_guard<mutex> lock(bufferMutex);
+        map<string, double> stats;
+        stats["write_behind_pending"] = static_cast<double>(pending.size());
+        stats["write_behind_rows_written"] = static_cast<double>(rowsWritten);
+        stats["write_behind_batches"] = static_cast<double>(batchesWritten);
+        stats["write_behind_failed_batches"] = static_cast<double>(failedBatches);
+        stats["write_behind_dropped_rows"] = static_cast<double>(droppedRows);
+        stats["write_behind_consecutive_failures"] = static_cast<double>(consecutiveFailures);
+        return stats;
+    }
+    
+private:
+    bool writeNextBatch(bool finalAttempt) {
+        // Serialize writers so batches reach the sink in enqueue order
+        lock_guard<mutex> writeLock(writeMutex);
+        
+        vector<vector<string>> batch;
+        {
+            lock_guard<mutex> lock(bufferMutex);
+            size_t take = min(pending.size(), maxRows);
+            batch.assign(make_move_iterator(pending.begin()), make_move_iterator(pending.begin() + take));
+            pending.erase(pending.begin(), pending.begin() + take);
+        }
+        if (batch.empty()) return false;
+        spaceAvailable.notify_all();
+        
+        if (flushBatch(batch)) {
+            lock_guard<mutex> lock(bufferMutex);
+            rowsWritten += batch.size();
+            batchesWritten++;
+            consecutiveFailures = 0;
+            retryAt = chrono::steady_clock::time_point();
+            return true;
+        }
+        
+        int attempts;
+        {
+            lock_guard<mutex> lock(bufferMutex);
+            failedBatches++;
+            attempts = ++consecutiveFailures;
+            
+            // Decision making - requeue at the front and back off until the retry budget is spent;
+            // producers blocked on a full backlog start shedding rows instead of waiting
+            if (!finalAttempt && consecutiveFailures < maxAttempts) {
+                pending.insert(pending.begin(), make_move_iterator(batch.begin()), make_move_iterator(batch.end()));
+                retryAt = chrono::steady_clock::now() + min(maxBackoff, baseBackoff * (1 << (consecutiveFailures - 1)));
+                spaceAvailable.notify_all();
+                return false;
+            }
+            
+            droppedRows += batch.size();
+            consecutiveFailures = 0;
+            retryAt = chrono::steady_clock::time_point();
+        }
+        
+        cerr << "Write-behind batch failed " << attempts << (attempts == 1 ? " time" : " times")
+             << ", dropped " << batch.size() << " rows" << endl;
+        if (errorHandler) {
+            errorHandler(batch);
+        }
+        return true;
+    }
+    
+    void run() {
+        unique_lock<mutex> lock(bufferMutex);
+        
+        // Loop - flush every maxRows rows or every maxDelay, whichever comes first,
+        // but hold off until retryAt while a failed batch is backing off
+        while (!stopping) {
+            if (retryAt != chrono::steady_clock::time_point()) {
+                flushNeeded.wait_until(lock, retryAt, [this]() { return stopping; });
+            } else {
+                flushNeeded.wait_for(lock, maxDelay, [this]() { return stopping || pending.size() >= maxRows; });
+            }
+            if (stopping) break;
+            if (pending.empty()) continue;
+            if (chrono::steady_clock::now() < retryAt) continue;
+            
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+};
+
 class DataService {
 private:
     DatabaseManager* databaseManager;
@@ -21,11 +584,32 @@ private:
     queue<string> processingQueue;
     map<string, int> dataStats;
     mutex serviceMutex;
+    shared_ptr<ResultCache> resultCache;   // swapped with atomic_store; workers atomic_load a reference
     
-    // Decision making variables
-    bool enableValidation;
+    // Streaming consumers - copy-on-write snapshot; writers replace it under streamMutex,
+    // publishResult atomic_loads it once per result
+    struct ResultConsumers {
+        vector<shared_ptr<ResultStream>> streams;
+        vector<function<void(const string&)>> subscribers;
+    };
+    mutex streamMutex;
+    shared_ptr<const ResultConsumers> resultConsumers;
+    
+    // Adaptive tuning
+    unique_ptr<AdaptiveController> adaptiveController;
+    
+    // Persistence
+    unique_ptr<WriteBehindBuffer> writeBehind;
+    
+    // Decision making variables - validation and threshold are re-applied by workers while others read them
+    atomic<bool> enableValidation;
     bool enableTransformation;
     int maxRetries;
+    chrono::milliseconds retryBackoff;
+    atomic<int> complexityThreshold;
+    
+    // Items processed between reads of the adaptive controller's decisions in processBatch
+    static const size_t adaptiveDecisionInterval = 64;
     
     // Calculation variables
     int totalProcessed;
@@ -38,10 +622,15 @@ private:
     
 public:
     DataService() : databaseManager(nullptr), enableValidation(true), 
-                   enableTransformation(true), maxRetries(3), totalProcessed(0),
+                   enableTransformation(true), maxRetries(3), retryBackoff(100), complexityThreshold(10), totalProcessed(0),
                    successfulProcessed(0), averageProcessingTime(0.0), 
                    initialized(false), currentMode("normal") {}
     
+    ~DataService() {
+        closeResultStreams();
+        writeBehind.reset();
+    }
+    
     bool initialize(DatabaseManager* dbManager) {
         databaseManager = dbManager;
         initialized = true;
@@ -60,11 +649,57 @@ public:
     bool processItem(const string& item, const string& mode) {
         if (!initialized) return false;
         
+        // Decision making - pick up adaptive threshold and validation changes before the
+        // cache lookup, so cached and uncached items see the same decisions
+        if (adaptiveController) {
+            applyAdaptiveDecisions();
+        }
+        return runPipeline(item, mode);
+    }
+    
+private:
+    bool runPipeline(const string& item, const string& mode) {
         auto start = chrono::high_resolution_clock::now();
         
+        // Decision making - duplicate inputs skip the pipeline entirely
+        shared_ptr<ResultCache> cache = atomic_load(&resultCache);
+        ResultCache::Entry cached;
+        if (cache && cache->lookup(mode, item, cached)) {
+            if (cached.success) {
+                storeResult(cached.transformed);
+                updateStats(cached.transformed);
+            } else if (!cached.valid) {
+                cerr << "Data validation failed for item" << endl;
+            }
+            
+            auto end = chrono::high_resolution_clock::now();
+            updateProcessingMetrics(chrono::duration<double>(end - start).count(), cached.success);
+            return cached.success;
+        }
+        
         // Decision making - validate input
-        if (enableValidation && !validateData(item)) {
+        bool valid = true;
+        if (enableValidation) {
+            auto validationStart = chrono::high_resolution_clock::now();
+            valid = validateData(item);
+            if (adaptiveController) {
+                auto validationEnd = chrono::high_resolution_clock::now();
+                adaptiveController->recordValidation(chrono::duration<double>(validationEnd - validationStart).count());
+            }
+        }
+        
+        if (!valid) {
             cerr << "Data validation failed for item" << endl;
+            if (adaptiveController) {
+                adaptiveController->recordRejection();
+            }
+            if (cache) {
+                cache->insert(mode, item, ResultCache::Entry{"", "", false, false});
+            }
+
+            // Calculation - failed validations count toward metrics on both cache paths
+            auto end = chrono::high_resolution_clock::now();
+            updateProcessingMetrics(chrono::duration<double>(end - start).count(), false);
             return false;
         }
         
@@ -78,15 +713,25 @@ public:
         string strategy = selectProcessingStrategy(processedItem, mode);
         
         // Loop - retry processing if needed
+        auto executionStart = chrono::high_resolution_clock::now();
         bool success = false;
         for (int attempt = 0; attempt < maxRetries && !success; ++attempt) {
             success = executeProcessing(processedItem, strategy);
             
             if (!success && attempt < maxRetries - 1) {
-                this_thread::sleep_for(chrono::milliseconds(100 * (attempt + 1)));
+                this_thread::sleep_for(retryBackoff * (attempt + 1));
             }
         }
         
+        if (adaptiveController) {
+            auto executionEnd = chrono::high_resolution_clock::now();
+            adaptiveController->recordExecution(strategy, chrono::duration<double>(executionEnd - executionStart).count(), success);
+        }
+        
+        if (cache) {
+            cache->insert(mode, item, ResultCache::Entry{processedItem, strategy, success, true});
+        }
+        
         if (success) {
             // Service call - store result
             storeResult(processedItem);
@@ -100,6 +745,97 @@ public:
         return success;
     }
     
+public:
+    void enableResultCache(size_t memoryBudgetBytes) {
+        // Decision making - workers holding the previous cache finish with it before it is freed
+        atomic_store(&resultCache, make_shared<ResultCache>(memoryBudgetBytes));
+    }
+    
+    void disableResultCache() {
+        atomic_store(&resultCache, shared_ptr<ResultCache>());
+    }
+    
+    void enableWriteBehind(function<bool(const vector<vector<string>>&)> flushBatch,
+                           size_t batchRows, chrono::milliseconds flushInterval,
+                           function<void(const vector<vector<string>>&)> onDropped = nullptr) {
+        // Service call - flushBatch persists one batch per call, e.g. via
+        // DatabaseManager::executePreparedBatch("insert_data", rows) in a single transaction
+        writeBehind.reset(new WriteBehindBuffer(move(flushBatch), batchRows, flushInterval));
+        if (onDropped) {
+            writeBehind->setErrorHandler(move(onDropped));
+        }
+    }
+    
+    void flushWriteBehind() {
+        if (writeBehind) {
+            writeBehind->flush();
+        }
+    }
+    
+    void setRetryPolicy(int retries, chrono::milliseconds backoff) {
+        // Decision making - backoff grows linearly per attempt; zero disables the sleeps
+        maxRetries = max(retries, 1);
+        retryBackoff = backoff;
+    }
+    
+    void enableAdaptiveControl(double latencySloSeconds) {
+        // Decision making - controller starts from the current static settings
+        adaptiveController.reset(new AdaptiveController(latencySloSeconds, complexityThreshold, enableValidation));
+    }
+    
+    int processBatch(const vector<string>& items, const string& mode) {
+        if (!initialized) return 0;
+        int successCount = 0;
+        size_t position = 0;
+        
+        // Loop - controller decisions are read once per chunk instead of once per item
+        while (position < items.size()) {
+            size_t chunk = items.size();
+            if (adaptiveController) {
+                applyAdaptiveDecisions();
+                chunk = adaptiveDecisionInterval;
+            }
+            size_t end = min(items.size(), position + chunk);
+            
+            for (size_t i = position; i < end; ++i) {
+                if (runPipeline(items[i], mode)) {
+                    successCount++;
+                }
+            }
+            position = end;
+        }
+        
+        return successCount;
+    }
+    
+    shared_ptr<ResultStream> openResultStream(size_t capacity) {
+        // Service call - register a bounded pull stream fed by storeResult
+        auto stream = make_shared<ResultStream>(capacity);
+        lock_guard<mutex> lock(streamMutex);
+        auto consumers = copyResultConsumers();
+        consumers->streams.push_back(stream);
+        atomic_store(&resultConsumers, shared_ptr<const ResultConsumers>(move(consumers)));
+        return stream;
+    }
+    
+    void subscribe(function<void(const string&)> callback) {
+        // Callbacks run on the producing thread and receive the result by reference
+        lock_guard<mutex> lock(streamMutex);
+        auto consumers = copyResultConsumers();
+        consumers->subscribers.push_back(move(callback));
+        atomic_store(&resultConsumers, shared_ptr<const ResultConsumers>(move(consumers)));
+    }
+    
+    void closeResultStreams() {
+        lock_guard<mutex> lock(streamMutex);
+        shared_ptr<const ResultConsumers> consumers = atomic_load(&resultConsumers);
+        if (!consumers) return;
+        for (auto& stream : consumers->streams) {
+            stream->close();
+        }
+        atomic_store(&resultConsumers, shared_ptr<const ResultConsumers>());
+    }
+    
     vector<string> getProcessedResults() {
         lock_guard<mutex> lock(serviceMutex);
         vector<string> results = processedResults;
@@ -180,7 +916,7 @@ public:
         
         if (mode == "fast") {
             return "minimal";
-        } else if (complexity < 10) {
+        } else if (complexity < complexityThreshold) {
             return "standard";
         } else {
             return "advanced";
@@ -248,14 +984,51 @@ public:
     }
     
     void storeResult(const string& result) {
-        lock_guard<mutex> lock(serviceMutex);
-        processedResults.push_back(result);
+        {
+            lock_guard<mutex> lock(serviceMutex);
+            processedResults.push_back(result);
+        }
         
-        // Service call - store in database if available
-        if (databaseManager) {
-            vector<string> params = {result, "processed"};
-            // databaseManager->executePreparedQuery("insert_data", params);
+        // Service call - queue for batched database insert if persistence is wired
+        if (writeBehind) {
+            writeBehind->enqueue({result, "processed"});
         }
+        
+        publishResult(result);
+    }
+    
+    void publishResult(const string& result) {
+        // Decision making - streams may block the producer, so deliver from the current snapshot
+        // without holding serviceMutex or streamMutex while pushing
+        shared_ptr<const ResultConsumers> consumers = atomic_load(&resultConsumers);
+        if (!consumers) return;
+        
+        for (const auto& callback : consumers->subscribers) {
+            callback(result);
+        }
+        
+        // Loop - deliver to open streams, noting whether a consumer has closed one
+        bool sawClosed = false;
+        for (const auto& stream : consumers->streams) {
+            if (!stream->push(result)) {
+                sawClosed = true;
+            }
+        }
+        
+        if (sawClosed) {
+            lock_guard<mutex> lock(streamMutex);
+            auto remaining = copyResultConsumers();
+            remaining->streams.erase(remove_if(remaining->streams.begin(), remaining->streams.end(),
+                                               [](const shared_ptr<ResultStream>& stream) { return stream->isClosed(); }),
+                                     remaining->streams.end());
+            atomic_store(&resultConsumers, shared_ptr<const ResultConsumers>(move(remaining)));
+        }
+    }
+    
+    // Caller holds streamMutex
+    shared_ptr<ResultConsumers> copyResultConsumers() {
+        shared_ptr<const ResultConsumers> current = atomic_load(&resultConsumers);
+        return current ? make_shared<ResultConsumers>(*current) : make_shared<ResultConsumers>();
     }
     
     void updateStats(const string& data) {
@@ -315,25 +1088,71 @@ public:
         metrics["success_rate"] = totalProcessed > 0 ? static_cast<double>(successfulProcessed) / totalProcessed : 0.0;
         metrics["total_processed"] = static_cast<double>(totalProcessed);
         
+        // Decision making - include cache statistics when caching is enabled
+        if (shared_ptr<ResultCache> cache = atomic_load(&resultCache)) {
+            auto cacheStats = cache->getStats();
+            metrics.insert(cacheStats.begin(), cacheStats.end());
+        }
+        
+        // Decision making - expose adaptive decisions when the controller is active
+        if (adaptiveController) {
+            auto adaptiveMetrics = adaptiveController->getMetrics();
+            metrics.insert(adaptiveMetrics.begin(), adaptiveMetrics.end());
+        }
+        
+        if (writeBehind) {
+            auto writeMetrics = writeBehind->getStats();
+            metrics.insert(writeMetrics.begin(), writeMetrics.end());
+        }
+        
         return metrics;
     }
     
     bool shouldEnableValidation() {
+        // Decision making - defer to measured cost when adaptive control is enabled
+        if (adaptiveController) {
+            return adaptiveController->shouldValidate();
+        }
+        
         // Decision making based on error rate
         double errorRate = 1.0 - calculateProcessingEfficiency();
         return errorRate > 0.1; // Enable validation if error rate > 10%
     }
     
     void updateValidationSettings() {
-        // Decision making - update validation settings
-        enableValidation = shouldEnableValidation();
-        if (enableValidation) {
-            cout << "Data validation enabled due to high error rate" << endl;
+        // Decision making - update validation settings; exchange lets exactly one caller see the change
+        bool desired = shouldEnableValidation();
+        bool previous = enableValidation.exchange(desired);
+        
+        // Decision making - cached outcomes depend on the validation setting
+        shared_ptr<ResultCache> cache = atomic_load(&resultCache);
+        if (cache && previous != desired) {
+            cache->clear();
+        }
+    }
+    
+    bool isValidationEnabled() const {
+        return enableValidation;
+    }
+    
+    void applyAdaptiveDecisions() {
+        // Decision making - cached outcomes depend on the strategy threshold and validation setting
+        int threshold = adaptiveController->getComplexityThreshold();
+        bool validate = adaptiveController->shouldValidate();
+        bool thresholdChanged = complexityThreshold.exchange(threshold) != threshold;
+        bool validationChanged = enableValidation.exchange(validate) != validate;
+        
+        if (thresholdChanged || validationChanged) {
+            if (shared_ptr<ResultCache> cache = atomic_load(&resultCache)) {
+                cache->clear();
+            }
         }
     }
 };
 
 // Main function to demonstrate DataService
+// (define DATASERVICE_NO_MAIN to reuse the class, e.g. from DataServiceBenchmark.cpp)
+#ifndef DATASERVICE_NO_MAIN
 int main() {
     cout << "=== DataService Demo ===" << endl;
     
@@ -426,6 +1245,7 @@ int main() {
     // Test validation settings update
     cout << "\n--- Validation Settings Update ---" << endl;
     dataService.updateValidationSettings();
+    cout << "Validation enabled: " << (dataService.isValidationEnabled() ? "Yes" : "No") << endl;
     
     // Get performance metrics
     cout << "\n--- Performance Metrics ---" << endl;
@@ -459,10 +1279,83 @@ int main() {
     
     cout << "Batch processing completed: " << successCount << "/" << batchData.size() << " successful" << endl;
     
+    // Test result cache with duplicate-heavy input
+    cout << "\n--- Result Cache Test ---" << endl;
+    dataService.enableResultCache(1024 * 1024);
+    
+    int cachedSuccessCount = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& item : batchData) {
+            if (dataService.processItem(item, "normal")) {
+                cachedSuccessCount++;
+            }
+        }
+    }
+    
+    auto cacheMetrics = dataService.getPerformanceMetrics();
+    cout << "Cached processing: " << cachedSuccessCount << "/" << batchData.size() * 3 << " successful" << endl;
+    cout << "Cache hits: " << cacheMetrics["cache_hits"] << ", misses: " << cacheMetrics["cache_misses"] << endl;
+    
+    // Test streaming consumers
+    cout << "\n--- Result Streaming Test ---" << endl;
+    int callbackCount = 0;
+    dataService.subscribe([&callbackCount](const string&) { callbackCount++; });
+    
+    auto stream = dataService.openResultStream(2);
+    int streamedCount = 0;
+    thread consumer([&stream, &streamedCount]() {
+        string result;
+        while (stream->pop(result)) {
+            streamedCount++;
+        }
+    });
+    
+    for (const auto& item : batchData) {
+        dataService.processItem(item, "thorough");
+    }
+    dataService.closeResultStreams();
+    consumer.join();
+    
+    auto streamStats = stream->getStats();
+    cout << "Streamed results: " << streamedCount << ", callback results: " << callbackCount << endl;
+    cout << "Producer waits (backpressure): " << streamStats["producer_waits"] << endl;
+    
+    // Test adaptive strategy selection
+    cout << "\n--- Adaptive Control Test ---" << endl;
+    dataService.disableResultCache();
+    dataService.enableAdaptiveControl(0.0005);
+    
+    vector<string> adaptiveData;
+    for (int i = 0; i < 200; ++i) {
+        adaptiveData.push_back("Adaptive item " + to_string(i) + " with Mixed Content and value " + to_string(i * 7));
+    }
+    
+    int adaptiveSuccess = dataService.processBatch(adaptiveData, "normal");
+    cout << "Adaptive batch: " << adaptiveSuccess << "/" << adaptiveData.size() << " successful" << endl;
+    
+    auto adaptiveMetrics = dataService.getPerformanceMetrics();
+    cout << "Complexity threshold: " << adaptiveMetrics["adaptive_complexity_threshold"] << endl;
+    cout << "Validation enabled: " << (adaptiveMetrics["adaptive_validation"] > 0.0 ? "Yes" : "No") << endl;
+    
+    // Test write-behind persistence with an in-memory sink standing in for DatabaseManager
+    cout << "\n--- Write-Behind Persistence Test ---" << endl;
+    atomic<int> persistedRows(0);
+    atomic<int> persistedBatches(0);
+    dataService.enableWriteBehind([&persistedRows, &persistedBatches](const vector<vector<string>>& rows) {
+        persistedRows += static_cast<int>(rows.size());
+        persistedBatches++;
+        return true;
+    }, 50, chrono::milliseconds(20));
+    
+    dataService.processBatch(adaptiveData, "fast");
+    dataService.flushWriteBehind();
+    cout << "Persisted " << persistedRows << " rows in " << persistedBatches << " batches" << endl;
+    
     // Get final results
     auto finalResults = dataService.getProcessedResults();
     cout << "Final processed results count: " << finalResults.size() << endl;
     
     cout << "\nDataService demo completed successfully!" << endl;
     return 0;
-}
\ No newline at end of file
+}
+#endif
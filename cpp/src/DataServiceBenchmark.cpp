@@ -0,0 +1,358 @@
+#define DATASERVICE_NO_MAIN
+#include "DataService.cpp"
+
+#include <fstream>
+#include <random>
+#include <iomanip>
+#include <ctime>
+
+using namespace std;
+
+// Corpus configuration for synthetic benchmark input
+struct CorpusConfig {
+    size_t itemCount = 10000;
+    int minLength = 20;
+    int maxLength = 120;
+    double alphaRatio = 0.70;
+    double digitRatio = 0.20;
+    double specialRatio = 0.05; // remaining characters are spaces
+    double duplicateRatio = 0.0;
+    unsigned int seed = 42;
+};
+
+// Corpus generator class for controllable DataService input
+class CorpusGenerator {
+public:
+    static vector<string> generate(const CorpusConfig& config) {
+        mt19937 rng(config.seed);
+        uniform_int_distribution<int> lengthDist(config.minLength, max(config.minLength, config.maxLength));
+        uniform_real_distribution<double> unit(0.0, 1.0);
+        uniform_int_distribution<int> wordLengthDist(3, 8);
+        
+        const string alpha = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        const string digits = "0123456789";
+        const string special = "@#$%&*!?.,;:-_";
+        
+        vector<string> corpus;
+        corpus.reserve(config.itemCount);
+        
+        // Loop - build each item, copying an earlier one for the duplicate share
+        for (size_t i = 0; i < config.itemCount; ++i) {
+            if (!corpus.empty() && unit(rng) < config.duplicateRatio) {
+                uniform_int_distribution<size_t> pick(0, corpus.size() - 1);
+                corpus.push_back(corpus[pick(rng)]);
+                continue;
+            }
+            
+            int length = lengthDist(rng);
+            string item;
+            item.reserve(length);
+            int wordRemaining = wordLengthDist(rng);
+            
+            while (static_cast<int>(item.size()) < length) {
+                // Decision making - words are separated by single spaces
+                if (wordRemaining == 0) {
+                    item += ' ';
+                    wordRemaining = wordLengthDist(rng);
+                    continue;
+                }
+                
+                double r = unit(rng) * (config.alphaRatio + config.digitRatio + config.specialRatio);
+                if (r < config.alphaRatio) {
+                    item += alpha[rng() % alpha.size()];
+                } else if (r < config.alphaRatio + config.digitRatio) {
+                    item += digits[rng() % digits.size()];
+                } else {
+                    item += special[rng() % special.size()];
+                }
+                wordRemaining--;
+            }
+            corpus.push_back(item);
+        }
+        
+        return corpus;
+    }
+};
+
+// Keeps a benchmarked result observable so the optimizer cannot drop the call
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Benchmark result for one measured operation
+struct BenchmarkResult {
+    string name;
+    long long iterations = 0;
+    double itemsPerSecond = 0.0;
+    double meanNs = 0.0;
+    double p50Ns = 0.0;
+    double p99Ns = 0.0;
+};
+
+// Benchmark runner class - Google-Benchmark-style registry, filter and JSON output
+class BenchmarkRunner {
+private:
+    struct Benchmark {
+        string name;
+        function<void(const string&)> run;
+        function<void()> reset; // restores cold state after warm-up and between passes, e.g. empties caches
+    };
+    
+    // Throughput comes from batches of timedBatch items; the items after each batch are timed
+    // one by one for the latency percentiles
+    static constexpr size_t timedBatch = 256;
+    static constexpr size_t latencySamplesPerBatch = 16;
+    
+    vector<Benchmark> benchmarks;
+    vector<BenchmarkResult> results;
+    double minTimeSeconds;
+    string filter;
+
+public:
+    BenchmarkRunner(double minTime, const string& nameFilter) : minTimeSeconds(minTime), filter(nameFilter) {}
+    
+    void add(const string& name, function<void(const string&)> run, function<void()> reset = nullptr) {
+        benchmarks.push_back({name, move(run), move(reset)});
+    }
+    
+    void runAll(const vector<string>& corpus) {
+        cout << left << setw(36) << "Benchmark" << right << setw(14) << "Items/sec"
+             << setw(12) << "Mean(ns)" << setw(12) << "p50(ns)" << setw(12) << "p99(ns)" << endl;
+        cout << "(mean from " << timedBatch << "-item batches; p50/p99 from " << latencySamplesPerBatch
+             << " individually timed items after each batch)" << endl;
+        cout << string(86, '-') << endl;
+        
+        for (auto& benchmark : benchmarks) {
+            // Decision making - substring filter like --benchmark_filter
+            if (!filter.empty() && benchmark.name.find(filter) == string::npos) continue;
+            
+            BenchmarkResult result = measure(benchmark, corpus);
+            results.push_back(result);
+            
+            cout << left << setw(36) << result.name << right << fixed << setprecision(0)
+                 << setw(14) << result.itemsPerSecond << setw(12) << result.meanNs
+                 << setw(12) << result.p50Ns << setw(12) << result.p99Ns << endl;
+        }
+    }
+    
+    bool writeJson(const string& path, const CorpusConfig& config) {
+        // IO call - write results for regression tracking
+        ofstream out(path);
+        if (!out.is_open()) {
+            cerr << "Failed to open benchmark output: " << path << endl;
+            return false;
+        }
+        
+        time_t now = time(nullptr);
+        char dateBuffer[32];
+        strftime(dateBuffer, sizeof(dateBuffer), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+        
+        out << "{\n";
+        out << "  \"context\": {\n";
+        out << "    \"date\": \"" << dateBuffer << "\",\n";
+        out << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n";
+        out << "    \"min_time\": " << minTimeSeconds << ",\n";
+        out << "    \"corpus\": {\"items\": " << config.itemCount << ", \"min_length\": " << config.minLength
+            << ", \"max_length\": " << config.maxLength << ", \"alpha_ratio\": " << config.alphaRatio
+            << ", \"digit_ratio\": " << config.digitRatio << ", \"special_ratio\": " << config.specialRatio
+            << ", \"duplicate_ratio\": " << config.duplicateRatio << ", \"seed\": " << config.seed << "}\n";
+        out << "  },\n";
+        out << "  \"benchmarks\": [\n";
+        
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << fixed << setprecision(2)
+                << ", \"items_per_second\": " << r.itemsPerSecond
+                << ", \"mean_ns\": " << r.meanNs
+                << ", \"p50_ns\": " << r.p50Ns
+                << ", \"p99_ns\": " << r.p99Ns << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        
+        out << "  ]\n";
+        out << "}\n";
+        return true;
+    }
+
+private:
+    BenchmarkResult measure(Benchmark& benchmark, const vector<string>& corpus) {
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        if (corpus.empty()) return result;
+        
+        // Warm-up pass over a slice of the corpus
+        size_t warmup = min<size_t>(corpus.size(), 1000);
+        for (size_t i = 0; i < warmup; ++i) {
+            benchmark.run(corpus[i]);
+        }
+        if (benchmark.reset) {
+            benchmark.reset();
+        }
+        
+        vector<double> latencies;
+        double batchedSeconds = 0.0;
+        double totalSeconds = 0.0;
+        long long batchedItems = 0;
+        long long iterations = 0;
+        
+        // Loop - whole passes over the corpus until the minimum time has elapsed; each later pass
+        // starts from the reset state, so cache hits follow the corpus duplicate ratio every time
+        for (int pass = 0; pass == 0 || totalSeconds < minTimeSeconds; ++pass) {
+            if (pass > 0 && benchmark.reset) {
+                benchmark.reset();
+            }
+            
+            size_t position = 0;
+            while (position < corpus.size()) {
+                size_t batchEnd = min(corpus.size(), position + timedBatch);
+                auto start = chrono::steady_clock::now();
+                for (size_t i = position; i < batchEnd; ++i) {
+                    benchmark.run(corpus[i]);
+                }
+                auto end = chrono::steady_clock::now();
+                
+                double seconds = chrono::duration<double>(end - start).count();
+                batchedSeconds += seconds;
+                totalSeconds += seconds;
+                batchedItems += static_cast<long long>(batchEnd - position);
+                position = batchEnd;
+                
+                // One clock pair per item, so the tail is not averaged away
+                size_t sampleEnd = min(corpus.size(), position + latencySamplesPerBatch);
+                for (; position < sampleEnd; ++position) {
+                    auto itemStart = chrono::steady_clock::now();
+                    benchmark.run(corpus[position]);
+                    auto itemEnd = chrono::steady_clock::now();
+                    double itemSeconds = chrono::duration<double>(itemEnd - itemStart).count();
+                    latencies.push_back(itemSeconds * 1e9);
+                    totalSeconds += itemSeconds;
+                }
+            }
+            iterations += static_cast<long long>(corpus.size());
+        }
+        
+        // Calculation - throughput and mean from the batches, percentiles from single items
+        result.iterations = iterations;
+        result.itemsPerSecond = batchedSeconds > 0.0 ? batchedItems / batchedSeconds : 0.0;
+        result.meanNs = batchedItems > 0 ? batchedSeconds * 1e9 / batchedItems : 0.0;
+        if (!latencies.empty()) {
+            result.p50Ns = percentile(latencies, 0.50);
+            result.p99Ns = percentile(latencies, 0.99);
+        }
+        return result;
+    }
+    
+    static double percentile(vector<double>& samples, double fraction) {
+        size_t rank = static_cast<size_t>(fraction * (samples.size() - 1));
+        nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+};
+
+// Main function to run the DataService benchmark suite
+// Usage: DataServiceBenchmark [--benchmark_filter=<substr>] [--benchmark_min_time=<seconds>]
+//        [--benchmark_out=<file.json>] [--items=N] [--min_length=N] [--max_length=N]
+//        [--alpha=R] [--digits=R] [--special=R] [--duplicates=R] [--seed=N]
+int main(int argc, char* argv[]) {
+    CorpusConfig config;
+    string filter;
+    string outputPath;
+    double minTime = 0.5;
+    
+    // Loop - parse --key=value arguments
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string value = eq == string::npos ? "" : arg.substr(eq + 1);
+        
+        if (key == "--benchmark_filter") filter = value;
+        else if (key == "--benchmark_min_time") minTime = stod(value);
+        else if (key == "--benchmark_out") outputPath = value;
+        else if (key == "--items") config.itemCount = stoul(value);
+        else if (key == "--min_length") config.minLength = stoi(value);
+        else if (key == "--max_length") config.maxLength = stoi(value);
+        else if (key == "--alpha") config.alphaRatio = stod(value);
+        else if (key == "--digits") config.digitRatio = stod(value);
+        else if (key == "--special") config.specialRatio = stod(value);
+        else if (key == "--duplicates") config.duplicateRatio = stod(value);
+        else if (key == "--seed") config.seed = static_cast<unsigned int>(stoul(value));
+        else {
+            cerr << "Unknown argument: " << arg << endl;
+            return 1;
+        }
+    }
+    
+    cout << "=== DataService Benchmark ===" << endl;
+    vector<string> corpus = CorpusGenerator::generate(config);
+    cout << "Corpus: " << corpus.size() << " items, duplicates " << config.duplicateRatio << endl << endl;
+    
+    // Validation failures are reported on cerr per item; silence them while measuring
+    streambuf* savedCerr = cerr.rdbuf(nullptr);
+    
+    // Retry sleeps would dominate the measured means, so retries run back to back
+    DataService service;
+    service.initialize(nullptr);
+    service.setRetryPolicy(3, chrono::milliseconds(0));
+    
+    const size_t cacheBudget = 64 * 1024 * 1024;
+    DataService cachedService;
+    cachedService.initialize(nullptr);
+    cachedService.setRetryPolicy(3, chrono::milliseconds(0));
+    cachedService.enableResultCache(cacheBudget);
+    
+    vector<string> modes = {"fast", "normal", "thorough"};
+    vector<string> strategies = {"minimal", "standard", "advanced"};
+    long long processedSinceCleanup = 0;
+    
+    BenchmarkRunner runner(minTime, filter);
+    
+    runner.add("validateData", [&service](const string& item) {
+        doNotOptimize(service.validateData(item));
+    });
+    
+    for (const auto& mode : modes) {
+        runner.add("transformData/" + mode, [&service, mode](const string& item) {
+            string transformed = service.transformData(item, mode);
+            doNotOptimize(transformed);
+        });
+    }
+    
+    for (const auto& strategy : strategies) {
+        runner.add("strategy/" + strategy, [&service, strategy](const string& item) {
+            doNotOptimize(service.executeProcessing(item, strategy));
+        });
+    }
+    
+    // processItem retains every result, so results are dropped periodically to keep memory flat
+    for (const auto& mode : modes) {
+        runner.add("processItem/" + mode, [&service, &processedSinceCleanup, mode](const string& item) {
+            doNotOptimize(service.processItem(item, mode));
+            if (++processedSinceCleanup % 100000 == 0) service.cleanup();
+        });
+    }
+    
+    for (const auto& mode : modes) {
+        runner.add("processItem/" + mode + "/cached", [&cachedService, &processedSinceCleanup, mode](const string& item) {
+            doNotOptimize(cachedService.processItem(item, mode));
+            if (++processedSinceCleanup % 100000 == 0) cachedService.cleanup();
+        }, [&cachedService, cacheBudget]() {
+            // Start each cached run empty so warm-up entries do not inflate the hit rate
+            cachedService.enableResultCache(cacheBudget);
+        });
+    }
+    
+    runner.runAll(corpus);
+    cerr.rdbuf(savedCerr);
+    
+    if (!outputPath.empty()) {
+        if (!runner.writeJson(outputPath, config)) {
+            return 1;
+        }
+        cout << endl << "Results written to " << outputPath << endl;
+    }
+    
+    return 0;
+}
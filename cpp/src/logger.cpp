@@ -10,9 +10,419 @@
 #include <vector> // Added for std::vector
 #include <map>    // Added for std::map
 #include <algorithm> // Added for std::find
+#include <atomic>
+#include <memory>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <type_traits>
+#include <string_view>
+#include <charconv>
+#include <unordered_map>
+#include <iterator>
+#include <filesystem>
+#include <zlib.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 using namespace std;
 
+// Compile-time minimum level (0 DEBUG ... 4 CRITICAL); release builds drop DEBUG calls made
+// through LOG_DEBUG/logAt<> entirely, including evaluation of their message arguments
+#ifndef LOGGER_MIN_LEVEL
+#ifdef NDEBUG
+#define LOGGER_MIN_LEVEL 1
+#else
+#define LOGGER_MIN_LEVEL 0
+#endif
+#endif
+
+// Log levels, ordered by priority
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Critical = 4
+};
+
+// The message expression is only evaluated when both the compile-time and runtime filters pass
+#define LOG_AT(logger, level, message) \
+    do { \
+        if (static_cast<int>(level) >= LOGGER_MIN_LEVEL && (logger).isEnabled(level)) { \
+            (logger).log(level, message); \
+        } \
+    } while (0)
+#define LOG_DEBUG(logger, message) LOG_AT(logger, LogLevel::Debug, message)
+#define LOG_INFO(logger, message) LOG_AT(logger, LogLevel::Info, message)
+#define LOG_WARNING(logger, message) LOG_AT(logger, LogLevel::Warning, message)
+#define LOG_ERROR(logger, message) LOG_AT(logger, LogLevel::Error, message)
+#define LOG_CRITICAL(logger, message) LOG_AT(logger, LogLevel::Critical, message)
+
+// Deferred logging - the format string is registered once per call site and only the level and raw
+// arguments are recorded; "{}" placeholders are filled in by the writer thread or the offline decoder
+#define LOG_DEFERRED(logger, level, format, ...) \
+    do { \
+        if (static_cast<int>(level) >= LOGGER_MIN_LEVEL && (logger).isEnabled(level)) { \
+            static const uint32_t logFormatId = LogFormatRegistry::add(format); \
+            (logger).logDeferred(logFormatId, level, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+// Overflow policy for the asynchronous ring buffer
+enum class OverflowPolicy {
+    Block,              // producers wait for space; nothing is lost
+    Drop,               // new messages are discarded while the ring is full
+    DropLowerLevels     // DEBUG/INFO are discarded once the ring is 3/4 full; WARNING and above block
+};
+
+// Outcome of handing a record to the asynchronous writer
+enum class AsyncPush {
+    Queued,
+    Dropped,            // shed by the overflow policy
+    Stopped             // async mode ended first; the caller logs synchronously
+};
+
+// Thread tag - "[Thread-<hash>]" rendered once per thread and copied by value into records
+struct ThreadTag {
+    char text[32];
+    size_t length;
+    
+    static const ThreadTag& current() {
+        static thread_local ThreadTag tag = fromHash(currentHash());
+        return tag;
+    }
+    
+    static size_t currentHash() {
+        return hash<thread::id>{}(this_thread::get_id());
+    }
+    
+    static ThreadTag fromHash(size_t threadHash) {
+        ThreadTag tag;
+        int written = snprintf(tag.text, sizeof(tag.text), "[Thread-%zu]", threadHash);
+        tag.length = written > 0 ? min(static_cast<size_t>(written), sizeof(tag.text) - 1) : 0;
+        return tag;
+    }
+};
+
+// Log record captured on the caller thread; formatting happens on the writer thread
+struct LogRecord {
+    string message;
+    LogLevel level;
+    chrono::system_clock::time_point time;
+    ThreadTag thread;
+};
+
+// Log ring class - bounded lock-free MPSC queue (per-slot sequence numbers, one CAS per push)
+class LogRing {
+private:
+    struct Slot {
+        atomic<size_t> sequence;
+        LogRecord record;
+    };
+    
+    unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> enqueuePos;
+    alignas(64) atomic<size_t> dequeuePos;
+
+public:
+    explicit LogRing(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+        // Calculation - round capacity up to a power of two so positions wrap with a mask
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        slots.reset(new Slot[size]);
+        for (size_t i = 0; i < size; ++i) {
+            slots[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+    
+    bool tryPush(LogRecord& record) {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        
+        // Loop - claim the next slot, retrying only when another producer won the race
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            
+            if (difference == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    slot.record = move(record);
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // full
+            } else {
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Single consumer only
+    template <typename Consumer>
+    bool tryPop(Consumer&& consume) {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        Slot& slot = slots[pos & mask];
+        size_t sequence = slot.sequence.load(memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false; // empty
+        }
+        
+        consume(slot.record);
+        slot.record.message.clear();
+        slot.sequence.store(pos + mask + 1, memory_order_release);
+        dequeuePos.store(pos + 1, memory_order_relaxed);
+        return true;
+    }
+    
+    size_t size() const {
+        size_t head = enqueuePos.load(memory_order_relaxed);
+        size_t tail = dequeuePos.load(memory_order_relaxed);
+        return head > tail ? head - tail : 0;
+    }
+    
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+// Rotation policy - size and age limits, retained generations and compression
+struct RotationPolicy {
+    size_t maxBytes = 10 * 1024 * 1024;
+    chrono::seconds maxAge = chrono::seconds(0);   // 0 disables time-based rotation
+    int generations = 5;                           // rotated files kept, as <log>.<n>[.gz], highest newest
+    bool compress = true;
+};
+
+// Log format registry - static format strings of deferred call sites, addressed by id; the level
+// travels with each record because one call site may log at different levels
+struct LogFormat {
+    const char* format;
+};
+
+class LogFormatRegistry {
+public:
+    static uint32_t add(const char* format) {
+        lock_guard<mutex> lock(registryMutex());
+        formats().push_back({format});
+        return static_cast<uint32_t>(formats().size() - 1);
+    }
+    
+    static bool find(uint32_t id, LogFormat& format) {
+        lock_guard<mutex> lock(registryMutex());
+        if (id >= formats().size()) return false;
+        format = formats()[id];
+        return true;
+    }
+
+private:
+    static mutex& registryMutex() {
+        static mutex instance;
+        return instance;
+    }
+    
+    static deque<LogFormat>& formats() {
+        static deque<LogFormat> instance;
+        return instance;
+    }
+};
+
+// Deferred codec - raw argument encoding; each argument is a one-byte tag plus its payload
+struct DeferredCodec {
+    static string_view text(const string& value) { return value; }
+    static string_view text(string_view value) { return value; }
+    static string_view text(const char* value) { return value ? string_view(value) : string_view("(null)"); }
+    
+    template <typename T>
+    static size_t size(const T& value) {
+        typedef typename decay<T>::type Type;
+        if constexpr (is_same<Type, char>::value) {
+            return 2;
+        } else if constexpr (is_arithmetic<Type>::value) {
+            return 1 + 8;
+        } else {
+            return 1 + sizeof(uint32_t) + text(value).size();
+        }
+    }
+    
+    template <typename T>
+    static char* encode(char* out, const T& value) {
+        typedef typename decay<T>::type Type;
+        if constexpr (is_same<Type, char>::value) {
+            *out++ = 'c';
+            *out++ = value;
+        } else if constexpr (is_floating_point<Type>::value) {
+            double number = static_cast<double>(value);
+            *out++ = 'd';
+            memcpy(out, &number, 8);
+            out += 8;
+        } else if constexpr (is_integral<Type>::value && is_signed<Type>::value) {
+            int64_t number = static_cast<int64_t>(value);
+            *out++ = 'i';
+            memcpy(out, &number, 8);
+            out += 8;
+        } else if constexpr (is_integral<Type>::value) {
+            uint64_t number = static_cast<uint64_t>(value);
+            *out++ = 'u';
+            memcpy(out, &number, 8);
+            out += 8;
+        } else {
+            string_view view = text(value);
+            uint32_t length = static_cast<uint32_t>(view.size());
+            *out++ = 's';
+            memcpy(out, &length, sizeof(length));
+            out += sizeof(length);
+            memcpy(out, view.data(), view.size());
+            out += view.size();
+        }
+        return out;
+    }
+    
+    // Returns false for a truncated argument or an unknown tag; out then holds the text rendered so far
+    static bool render(string& out, const char* format, const char* args, const char* end) {
+        // Loop - copy the format, substituting the next decoded argument at each "{}"
+        for (const char* cursor = format; *cursor; ++cursor) {
+            if (cursor[0] != '{' || cursor[1] != '}' || args >= end) {
+                out += *cursor;
+                continue;
+            }
+            ++cursor;
+            
+            char tag = *args++;
+            char digits[32];
+            if (tag == 'c') {
+                if (end - args < 1) return false;
+                out += *args++;
+            } else if (tag == 'i' || tag == 'u') {
+                if (end - args < 8) return false;
+                uint64_t raw;
+                memcpy(&raw, args, 8);
+                args += 8;
+                auto result = tag == 'i' ? to_chars(digits, digits + sizeof(digits), static_cast<int64_t>(raw))
+                                         : to_chars(digits, digits + sizeof(digits), raw);
+                out.append(digits, result.ptr);
+            } else if (tag == 'd') {
+                if (end - args < 8) return false;
+                double number;
+                memcpy(&number, args, 8);
+                args += 8;
+                int written = snprintf(digits, sizeof(digits), "%g", number);
+                out.append(digits, written > 0 ? min(static_cast<size_t>(written), sizeof(digits) - 1) : 0);
+            } else if (tag == 's') {
+                uint32_t length;
+                if (end - args < static_cast<ptrdiff_t>(sizeof(length))) return false;
+                memcpy(&length, args, sizeof(length));
+                args += sizeof(length);
+                if (static_cast<size_t>(end - args) < length) return false;
+                out.append(args, length);
+                args += length;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Deferred record header, followed by the encoded arguments
+struct DeferredHeader {
+    uint32_t formatId;
+    uint32_t size;            // header plus arguments
+    LogLevel level;
+    int64_t timestampNs;      // system clock
+};
+
+// Deferred buffer class - per-thread SPSC byte ring; the owning thread appends, the writer drains
+class DeferredBuffer {
+private:
+    unique_ptr<char[]> storage;
+    size_t bytes;
+    size_t pendingPadding;
+    alignas(64) atomic<size_t> writePos;
+    alignas(64) atomic<size_t> readPos;
+
+public:
+    static const uint32_t paddingMarker = 0xFFFFFFFF;
+    
+    const size_t threadHash;
+    atomic<bool> retired;
+    
+    DeferredBuffer(size_t capacity, size_t ownerHash)
+        : storage(new char[capacity]), bytes(capacity), pendingPadding(0), writePos(0), readPos(0),
+          threadHash(ownerHash), retired(false) {}
+    
+    size_t capacity() const {
+        return bytes;
+    }
+    
+    char* reserve(size_t size) {
+        size_t write = writePos.load(memory_order_relaxed);
+        size_t read = readPos.load(memory_order_acquire);
+        size_t offset = write % bytes;
+        size_t contiguous = bytes - offset;
+        
+        // Decision making - records never wrap; the tail is skipped and the record starts at offset 0
+        size_t padding = contiguous < size ? contiguous : 0;
+        if (write + padding + size - read > bytes) return nullptr;
+        if (padding >= sizeof(uint32_t)) {
+            memcpy(storage.get() + offset, &paddingMarker, sizeof(paddingMarker));
+        }
+        pendingPadding = padding;
+        return storage.get() + (padding ? 0 : offset);
+    }
+    
+    void commit(size_t size) {
+        writePos.store(writePos.load(memory_order_relaxed) + pendingPadding + size, memory_order_release);
+    }
+    
+    template <typename Visitor>
+    size_t drain(Visitor&& visit) {
+        size_t read = readPos.load(memory_order_relaxed);
+        size_t write = writePos.load(memory_order_acquire);
+        size_t records = 0;
+        
+        // Loop - visit every committed record, skipping wrap padding
+        while (read < write) {
+            size_t offset = read % bytes;
+            size_t contiguous = bytes - offset;
+            uint32_t formatId = paddingMarker;
+            if (contiguous >= sizeof(DeferredHeader)) {
+                memcpy(&formatId, storage.get() + offset, sizeof(formatId));
+            }
+            if (formatId == paddingMarker) {
+                read += contiguous;
+                continue;
+            }
+            
+            DeferredHeader header;
+            memcpy(&header, storage.get() + offset, sizeof(header));
+            const char* args = storage.get() + offset + sizeof(header);
+            visit(header, args, args + (header.size - sizeof(header)));
+            read += header.size;
+            records++;
+        }
+        
+        readPos.store(read, memory_order_release);
+        return records;
+    }
+    
+    size_t written() const {
+        return writePos.load(memory_order_acquire);
+    }
+    
+    size_t consumed() const {
+        return readPos.load(memory_order_acquire);
+    }
+};
+
 class Logger {
 private:
     ofstream logFile;
@@ -20,97 +430,413 @@ private:
     mutex logMutex;
     queue<string> logQueue;
     
+    // Asynchronous pipeline
+    unique_ptr<LogRing> asyncRing;
+    OverflowPolicy overflowPolicy;
+    thread asyncWriter;
+    atomic<bool> asyncRunning;
+    atomic<int> asyncProducers;        // callers between the mode check and the end of their push
+    atomic<bool> asyncWriterIdle;
+    mutex asyncWakeMutex;
+    condition_variable asyncWake;
+    condition_variable asyncDrained;
+    atomic<long long> asyncPushed;
+    atomic<long long> asyncWritten;
+    atomic<long long> droppedCount;
+    atomic<long long> blockedCount;
+    atomic<long long> batchCount;
+    
+    // Deferred (binary) logging
+    const uint64_t instanceId;
+    mutex deferredMutex;
+    vector<shared_ptr<DeferredBuffer>> deferredBuffers;
+    ofstream binaryLog;                // raw records for the offline decoder, when enabled
+    vector<bool> formatsInBinaryLog;   // guarded by logMutex
+    
+    // Rotation, checked by whichever thread writes the file
+    RotationPolicy rotationPolicy;
+    size_t currentFileBytes;
+    chrono::steady_clock::time_point fileOpenedAt;
+    long long lastGeneration;
+    long long oldestRetainedGeneration;   // guarded by compressMutex
+    atomic<long long> rotationCount;
+    
+    // Background compression of rotated generations
+    thread compressorThread;
+    bool compressorRunning;            // guarded by compressMutex
+    mutex compressMutex;
+    condition_variable compressWake;
+    deque<string> compressQueue;
+    atomic<long long> compressedCount;
+    
     // Decision making variables
-    bool enableFileLogging;
-    bool enableConsoleLogging;
-    string logLevel;
+    bool fileLoggingEnabled;
+    bool consoleLoggingEnabled;
+    atomic<int> threshold;             // lowest LogLevel that is written
     int maxQueueSize;
     
     // Calculation variables
-    int totalLogs;
-    int errorCount;
-    int warningCount;
+    atomic<int> totalLogs;
+    atomic<int> errorCount;
+    atomic<int> warningCount;
+    
+    // Bytes accumulated before the writer issues one write per sink
+    static const size_t asyncBatchBytes = 64 * 1024;
+    
+    // Upper bound on how long a message waits in the ring before it is written
+    static constexpr chrono::milliseconds asyncPollInterval{5};
+    
+    // Per-thread deferred buffer size
+    static constexpr size_t deferredBufferBytes = 1 << 20;
+    
+    // Binary log layout: magic, then format definitions and records in write order
+    static constexpr const char* binaryLogMagic = "LOGBIN2\n";
+    static const uint32_t binaryFormatMarker = 0xFFFFFFFE;
     
 public:
-    Logger(const string& filename) : logPath(filename), enableFileLogging(true),
-                                   enableConsoleLogging(true), logLevel("INFO"),
+    Logger(const string& filename) : logPath(filename), overflowPolicy(OverflowPolicy::Block),
+                                   asyncRunning(false), asyncProducers(0), asyncWriterIdle(false), asyncPushed(0),
+                                   asyncWritten(0), droppedCount(0), blockedCount(0), batchCount(0),
+                                   instanceId(nextInstanceId()), currentFileBytes(0), lastGeneration(0),
+                                   oldestRetainedGeneration(0),
+                                   rotationCount(0), compressorRunning(false), compressedCount(0),
+                                   fileLoggingEnabled(true), consoleLoggingEnabled(true),
+                                   threshold(static_cast<int>(LogLevel::Info)),
                                    maxQueueSize(1000), totalLogs(0), errorCount(0),
                                    warningCount(0) {
         initializeLogger();
     }
     
     ~Logger() {
+        stopAsync();
         flushQueue();
+        stopCompressor();
         if (logFile.is_open()) {
             logFile.close();
         }
     }
     
-    void log(const string& message, const string& level = "INFO") {
-        // Decision making - check log level
-        if (!shouldLog(level)) {
+    bool isEnabled(LogLevel level) const {
+        // Single relaxed load - the only work done for filtered-out messages
+        return static_cast<int>(level) >= threshold.load(memory_order_relaxed);
+    }
+    
+    void log(LogLevel level, const string& message) {
+        // Decision making - check log level before any formatting or allocation
+        if (!isEnabled(level)) {
             return;
         }
         
-        string formattedMessage = formatMessage(message, level);
+        // Decision making - async mode captures the record and leaves formatting to the writer thread
+        if (enterAsyncProducer()) {
+            LogRecord record{message, level, chrono::system_clock::now(), ThreadTag::current()};
+            AsyncPush result = enqueueAsync(record);
+            leaveAsyncProducer();
+            if (result == AsyncPush::Queued) {
+                updateStats(level);
+            }
+            if (result != AsyncPush::Stopped) return;
+            // The writer stopped while this record waited for a slot; write it synchronously
+        }
+        
+        string formattedMessage;
+        formatRecord(formattedMessage, message, level, chrono::system_clock::now(), ThreadTag::current());
         
         // Decision making - add to queue or write directly
-        if (logQueue.size() >= maxQueueSize) {
+        bool queueFull;
+        {
+            lock_guard<mutex> lock(logMutex);
+            queueFull = logQueue.size() >= static_cast<size_t>(maxQueueSize);
+        }
+        if (queueFull) {
             flushQueue();
         }
         
         {
             lock_guard<mutex> lock(logMutex);
-            logQueue.push(formattedMessage);
+            logQueue.push(move(formattedMessage));
         }
         
         updateStats(level);
         
         // Decision making - immediate flush for critical messages
-        if (level == "CRITICAL" || level == "ERROR") {
+        if (level >= LogLevel::Error) {
             flushQueue();
         }
     }
     
+    void log(const string& message, const string& level = "INFO") {
+        // String wrapper - unrecognised level names are logged at INFO
+        LogLevel parsed = LogLevel::Info;
+        parseLevel(level, parsed);
+        log(parsed, message);
+    }
+    
+    template <LogLevel Level>
+    void logAt(const string& message) {
+        if constexpr (static_cast<int>(Level) >= LOGGER_MIN_LEVEL) {
+            log(Level, message);
+        }
+    }
+    
     void logInfo(const string& message) {
-        log(message, "INFO");
+        logAt<LogLevel::Info>(message);
     }
     
     void logWarning(const string& message) {
-        log(message, "WARNING");
+        logAt<LogLevel::Warning>(message);
     }
     
     void logError(const string& message) {
-        log(message, "ERROR");
+        logAt<LogLevel::Error>(message);
     }
     
     void logDebug(const string& message) {
-        log(message, "DEBUG");
+        logAt<LogLevel::Debug>(message);
     }
     
     void logCritical(const string& message) {
-        log(message, "CRITICAL");
+        logAt<LogLevel::Critical>(message);
+    }
+    
+    template <typename... Args>
+    void logDeferred(uint32_t formatId, LogLevel level, const Args&... args) {
+        if (!isEnabled(level)) return;
+        size_t size = sizeof(DeferredHeader) + (static_cast<size_t>(0) + ... + DeferredCodec::size(args));
+        DeferredHeader header{formatId, static_cast<uint32_t>(size), level,
+                              chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count()};
+        
+        // Decision making - without the writer thread, render on the caller like log()
+        if (!enterAsyncProducer()) {
+            logDeferredNow(formatId, level, size, args...);
+            return;
+        }
+        
+        DeferredBuffer* buffer = deferredBuffer();
+        if (size > buffer->capacity() / 4) {
+            leaveAsyncProducer();
+            droppedCount++;
+            return;
+        }
+        
+        char* out = buffer->reserve(size);
+        if (!out) {
+            if (overflowPolicy == OverflowPolicy::Drop ||
+                (overflowPolicy == OverflowPolicy::DropLowerLevels && level < LogLevel::Warning)) {
+                leaveAsyncProducer();
+                droppedCount++;
+                return;
+            }
+            
+            // Loop - Block policy: wait for the writer to drain this thread's buffer, unless async mode is being stopped
+            blockedCount++;
+            do {
+                if (!asyncRunning.load(memory_order_acquire)) {
+                    leaveAsyncProducer();
+                    logDeferredNow(formatId, level, size, args...);
+                    return;
+                }
+                wakeAsyncWriter();
+                this_thread::yield();
+            } while (!(out = buffer->reserve(size)));
+        }
+        
+        // Copy only the header and raw arguments; the writer thread renders the text
+        memcpy(out, &header, sizeof(header));
+        char* cursor = out + sizeof(header);
+        ((cursor = DeferredCodec::encode(cursor, args)), ...);
+        buffer->commit(size);
+        leaveAsyncProducer();
+    }
+    
+    bool startBinaryLog(const string& path) {
+        // IO call - deferred records go to this file unrendered; decode with decodeBinaryLog
+        lock_guard<mutex> lock(logMutex);
+        if (binaryLog.is_open()) binaryLog.close();
+        binaryLog.open(path, ios::binary | ios::trunc);
+        if (!binaryLog.is_open()) {
+            cerr << "Failed to open binary log file: " << path << endl;
+            return false;
+        }
+        binaryLog.write(binaryLogMagic, strlen(binaryLogMagic));
+        formatsInBinaryLog.clear();    // guarded by logMutex, like the file it describes
+        return true;
+    }
+    
+    void stopBinaryLog() {
+        flush();
+        lock_guard<mutex> lock(logMutex);
+        binaryLog.close();
+    }
+    
+    static bool decodeBinaryLog(const string& path, ostream& out) {
+        // IO call - read the whole binary log
+        ifstream in(path, ios::binary);
+        if (!in.is_open()) {
+            cerr << "Failed to open binary log file: " << path << endl;
+            return false;
+        }
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        size_t magicLength = strlen(binaryLogMagic);
+        if (data.compare(0, magicLength, binaryLogMagic) != 0) {
+            cerr << "Not a binary log file: " << path << endl;
+            return false;
+        }
+        
+        map<uint32_t, string> formats;
+        string line;
+        string message;
+        size_t position = magicLength;
+        const size_t recordPrefix = 2 * sizeof(uint32_t);
+        const size_t recordFields = sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t);
+        
+        // Loop - format definitions precede the first record that uses them
+        while (position + recordPrefix <= data.size()) {
+            uint32_t kind, size;
+            memcpy(&kind, data.data() + position, sizeof(kind));
+            memcpy(&size, data.data() + position + sizeof(kind), sizeof(size));
+            if (size < recordPrefix || size > data.size() - position) break; // truncated tail
+            const char* body = data.data() + position + recordPrefix;
+            const char* end = data.data() + position + size;
+            
+            if (kind == binaryFormatMarker) {
+                if (static_cast<size_t>(end - body) < sizeof(uint32_t)) {
+                    cerr << "Corrupt format definition at offset " << position << " in " << path << endl;
+                    return false;
+                }
+                uint32_t id;
+                memcpy(&id, body, sizeof(id));
+                formats[id] = string(body + sizeof(id), end);
+            } else {
+                auto format = formats.find(kind);
+                if (format == formats.end() || static_cast<size_t>(end - body) < recordFields) {
+                    cerr << "Corrupt record at offset " << position << " in " << path << endl;
+                    return false;
+                }
+                int64_t timestampNs;
+                uint64_t threadHash;
+                uint32_t level;
+                memcpy(&timestampNs, body, sizeof(timestampNs));
+                memcpy(&threadHash, body + sizeof(timestampNs), sizeof(threadHash));
+                memcpy(&level, body + sizeof(timestampNs) + sizeof(threadHash), sizeof(level));
+                
+                message.clear();
+                line.clear();
+                if (level > static_cast<uint32_t>(LogLevel::Critical) ||
+                    !DeferredCodec::render(message, format->second.c_str(), body + recordFields, end)) {
+                    cerr << "Corrupt record at offset " << position << " in " << path << endl;
+                    return false;
+                }
+                formatRecord(line, message, static_cast<LogLevel>(level),
+                             chrono::system_clock::time_point(chrono::duration_cast<chrono::system_clock::duration>(
+                                 chrono::nanoseconds(timestampNs))),
+                             ThreadTag::fromHash(static_cast<size_t>(threadHash)));
+                out << line << '\n';
+            }
+            position += size;
+        }
+        return true;
     }
     
     void flush() {
+        // Decision making - in async mode wait until everything pushed so far has been written
+        if (asyncRunning) {
+            long long target = asyncPushed.load();
+            vector<pair<shared_ptr<DeferredBuffer>, size_t>> deferredTargets;
+            {
+                lock_guard<mutex> lock(deferredMutex);
+                for (const auto& buffer : deferredBuffers) {
+                    deferredTargets.emplace_back(buffer, buffer->written());
+                }
+            }
+            
+            wakeAsyncWriter();
+            unique_lock<mutex> lock(asyncWakeMutex);
+            asyncDrained.wait(lock, [this, target, &deferredTargets]() {
+                if (!asyncRunning) return true;
+                for (const auto& deferred : deferredTargets) {
+                    if (deferred.first->consumed() < deferred.second) return false;
+                }
+                return asyncWritten.load() >= target;
+            });
+            return;
+        }
+        flushQueue();
+    }
+    
+    bool startAsync(size_t capacity = 8192, OverflowPolicy policy = OverflowPolicy::Block) {
+        if (asyncRunning) return false;
+        
+        // Anything logged synchronously so far is written before the writer takes over
         flushQueue();
+        asyncRing.reset(new LogRing(capacity));
+        overflowPolicy = policy;
+        asyncRunning = true;
+        asyncWriter = thread(&Logger::runAsyncWriter, this);
+        return true;
+    }
+    
+    void stopAsync() {
+        if (!asyncRunning) return;
+        
+        // The writer drains the ring before it exits
+        asyncRunning = false;
+        wakeAsyncWriter();
+        asyncWriter.join();
+        
+        // Callers that passed the mode check finish their push, or fall back to synchronous logging
+        while (asyncProducers.load() > 0) {
+            this_thread::yield();
+        }
+        
+        // Loop - pick up records from callers that passed the mode check just before shutdown
+        string batch;
+        while (asyncRing->tryPop([this, &batch](const LogRecord& record) {
+            formatRecord(batch, record.message, record.level, record.time, record.thread);
+            batch += '\n';
+        })) {}
+        drainDeferred(batch);
+        if (!batch.empty()) writeBatch(batch);
+        asyncDrained.notify_all();
+    }
+    
+    void setLogLevel(LogLevel level) {
+        threshold.store(static_cast<int>(level), memory_order_relaxed);
+        log(LogLevel::Info, string("Log level changed to ") + levelName(level));
     }
     
     void setLogLevel(const string& level) {
         // Decision making - validate log level
-        vector<string> validLevels = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
-        auto it = find(validLevels.begin(), validLevels.end(), level);
-        
-        if (it != validLevels.end()) {
-            logLevel = level;
-            log("Log level changed to " + level, "INFO");
+        LogLevel parsed;
+        if (parseLevel(level, parsed)) {
+            setLogLevel(parsed);
         } else {
-            log("Invalid log level: " + level, "WARNING");
+            log(LogLevel::Warning, "Invalid log level: " + level);
         }
     }
     
+    LogLevel getLogLevel() const {
+        return static_cast<LogLevel>(threshold.load(memory_order_relaxed));
+    }
+    
+    static const char* levelName(LogLevel level) {
+        static const char* const names[] = {"DEBUG", "INFO", "WARNING", "ERROR", "CRITICAL"};
+        return names[static_cast<int>(level)];
+    }
+    
+    static bool parseLevel(const string& name, LogLevel& level) {
+        for (int i = static_cast<int>(LogLevel::Debug); i <= static_cast<int>(LogLevel::Critical); ++i) {
+            if (name == levelName(static_cast<LogLevel>(i))) {
+                level = static_cast<LogLevel>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+    
     void enableFileLogging(bool enable) {
-        enableFileLogging = enable;
+        lock_guard<mutex> lock(logMutex);
+        fileLoggingEnabled = enable;
         if (!enable && logFile.is_open()) {
             logFile.close();
         } else if (enable && !logFile.is_open()) {
@@ -119,7 +845,8 @@ public:
     }
     
     void enableConsoleLogging(bool enable) {
-        enableConsoleLogging = enable;
+        lock_guard<mutex> lock(logMutex);
+        consoleLoggingEnabled = enable;
     }
     
     map<string, int> getLogStats() {
@@ -127,32 +854,57 @@ public:
         stats["total_logs"] = totalLogs;
         stats["errors"] = errorCount;
         stats["warnings"] = warningCount;
-        stats["queue_size"] = logQueue.size();
+        stats["queue_size"] = asyncRing ? static_cast<int>(asyncRing->size()) : static_cast<int>(logQueue.size());
+        stats["dropped"] = static_cast<int>(droppedCount.load());
+        stats["blocked"] = static_cast<int>(blockedCount.load());
+        stats["async_batches"] = static_cast<int>(batchCount.load());
+        stats["rotations"] = static_cast<int>(rotationCount.load());
+        stats["compressed"] = static_cast<int>(compressedCount.load());
+        {
+            lock_guard<mutex> lock(deferredMutex);
+            stats["deferred_buffers"] = static_cast<int>(deferredBuffers.size());
+        }
         
         return stats;
     }
     
+    void setRotationPolicy(const RotationPolicy& policy) {
+        lock_guard<mutex> lock(logMutex);
+        rotationPolicy = policy;
+        rotationPolicy.generations = max(rotationPolicy.generations, 1);
+        
+        // Decision making - generations still waiting (e.g. recovered at startup) stay uncompressed
+        if (!rotationPolicy.compress) {
+            lock_guard<mutex> compressLock(compressMutex);
+            compressQueue.clear();
+        }
+    }
+    
     void rotateLogFile() {
-        // Decision making - rotate log file if it's too large
-        if (logFile.is_open()) {
-            streampos fileSize = logFile.tellp();
-            if (fileSize > 10 * 1024 * 1024) { // 10MB
-                logFile.close();
-                
-                // IO call - rename current log file
-                string backupName = logPath + ".backup";
-                rename(logPath.c_str(), backupName.c_str());
-                
-                openLogFile();
-                log("Log file rotated", "INFO");
-            }
+        // Decision making - rotate now if the policy says the file is due
+        unique_lock<mutex> lock(logMutex);
+        if (shouldRotateLocked() && rotateLocked()) {
+            lock.unlock();
+            log("Log file rotated", "INFO");
+        }
+    }
+    
+    void performLogRotation() {
+        if (shouldRotateLog()) {
+            rotateLogFile();
         }
     }
     
 private:
     void initializeLogger() {
+        // Loop - continue numbering after generations left by earlier runs
+        for (long long generation : findGenerations()) {
+            lastGeneration = max(lastGeneration, generation);
+        }
+        recoverGenerations();
+        
         // Decision making - open log file
-        if (enableFileLogging) {
+        if (fileLoggingEnabled) {
             openLogFile();
         }
         
@@ -164,50 +916,472 @@ private:
         logFile.open(logPath, ios::app);
         if (!logFile.is_open()) {
             cerr << "Failed to open log file: " << logPath << endl;
-            enableFileLogging = false;
+            fileLoggingEnabled = false;
+            return;
         }
+        
+        error_code error;
+        uintmax_t existing = filesystem::file_size(logPath, error);
+        currentFileBytes = error ? 0 : static_cast<size_t>(existing);
+        fileOpenedAt = chrono::steady_clock::now();
     }
     
-    bool shouldLog(const string& level) {
-        // Decision making - check if level should be logged
-        map<string, int> levelPriority = {
-            {"DEBUG", 0},
-            {"INFO", 1},
-            {"WARNING", 2},
-            {"ERROR", 3},
-            {"CRITICAL", 4}
-        };
+    bool shouldRotateLocked() const {
+        if (!logFile.is_open()) return false;
         
-        auto currentPriority = levelPriority.find(logLevel);
-        auto messagePriority = levelPriority.find(level);
+        // Decision making - size limit, or age limit when configured
+        if (rotationPolicy.maxBytes > 0 && currentFileBytes >= rotationPolicy.maxBytes) return true;
+        return rotationPolicy.maxAge.count() > 0 && chrono::steady_clock::now() - fileOpenedAt >= rotationPolicy.maxAge;
+    }
+    
+    bool rotateLocked() {
+        // Caller holds logMutex, so no line is written between the rename and the reopen
+        logFile.flush();
+        string generationPath = logPath + "." + to_string(lastGeneration + 1);
+        if (rename(logPath.c_str(), generationPath.c_str()) != 0) {
+            cerr << "Failed to rotate log file: " << logPath << endl;
+            return false;
+        }
+        lastGeneration++;
+        rotationCount++;
+        logFile.close();
+        openLogFile();
         
-        if (currentPriority != levelPriority.end() && messagePriority != levelPriority.end()) {
-            return messagePriority->second >= currentPriority->second;
+        // Loop - drop generations beyond the retention count
+        {
+            lock_guard<mutex> lock(compressMutex);
+            oldestRetainedGeneration = lastGeneration - rotationPolicy.generations + 1;
+            for (long long generation : findGenerations()) {
+                if (generation >= oldestRetainedGeneration) continue;
+                string expired = logPath + "." + to_string(generation);
+                remove(expired.c_str());
+                remove((expired + ".gz").c_str());
+            }
         }
         
+        // Decision making - compression happens off the writer thread
+        if (rotationPolicy.compress) {
+            queueCompression(generationPath);
+        }
         return true;
     }
     
-    string formatMessage(const string& message, const string& level) {
-        // Calculation - format timestamp
-        auto now = chrono::system_clock::now();
-        auto time_t = chrono::system_clock::to_time_t(now);
-        auto ms = chrono::duration_cast<chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
+    void recoverGenerations() {
+        filesystem::path path(logPath);
+        filesystem::path directory = path.has_parent_path() ? path.parent_path() : filesystem::path(".");
+        string prefix = path.filename().string() + ".";
+        vector<string> uncompressed;
+        
+        // Loop - an earlier run may have crashed mid-compression or with generations still queued
+        error_code error;
+        for (filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            string name = it->path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            
+            string suffix = name.substr(prefix.size());
+            bool partial = suffix.size() > 7 && suffix.compare(suffix.size() - 7, 7, ".gz.tmp") == 0;
+            if (partial) suffix.resize(suffix.size() - 7);
+            if (suffix.empty() || suffix.find_first_not_of("0123456789") != string::npos) continue;
+            
+            string generationPath = logPath + "." + suffix;
+            if (partial) {
+                remove(it->path().string().c_str());
+            } else if (filesystem::exists(generationPath + ".gz", error)) {
+                // The .gz was published before the crash; only the source removal is missing
+                remove(generationPath.c_str());
+            } else {
+                uncompressed.push_back(generationPath);
+            }
+        }
+        
+        // Decision making - generations that never got compressed are queued again, oldest first
+        if (!rotationPolicy.compress) return;
+        sort(uncompressed.begin(), uncompressed.end(), [this](const string& a, const string& b) {
+            return stoll(a.substr(logPath.size() + 1)) < stoll(b.substr(logPath.size() + 1));
+        });
+        for (const auto& generationPath : uncompressed) {
+            queueCompression(generationPath);
+        }
+    }
+    
+    void queueCompression(const string& generationPath) {
+        startCompressor();
+        {
+            lock_guard<mutex> lock(compressMutex);
+            compressQueue.push_back(generationPath);
+        }
+        compressWake.notify_one();
+    }
+    
+    vector<long long> findGenerations() const {
+        vector<long long> generations;
+        filesystem::path path(logPath);
+        filesystem::path directory = path.has_parent_path() ? path.parent_path() : filesystem::path(".");
+        string prefix = path.filename().string() + ".";
+        
+        // Loop - match <log>.<n> and <log>.<n>.gz
+        error_code error;
+        for (filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+            string name = it->path().filename().string();
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            
+            string suffix = name.substr(prefix.size());
+            if (suffix.size() > 3 && suffix.compare(suffix.size() - 3, 3, ".gz") == 0) {
+                suffix.resize(suffix.size() - 3);
+            }
+            if (suffix.empty() || suffix.find_first_not_of("0123456789") != string::npos) continue;
+            generations.push_back(stoll(suffix));
+        }
+        return generations;
+    }
+    
+    void startCompressor() {
+        lock_guard<mutex> lock(compressMutex);
+        if (compressorRunning) return;
+        compressorRunning = true;
+        compressorThread = thread(&Logger::runCompressor, this);
+    }
+    
+    void stopCompressor() {
+        {
+            lock_guard<mutex> lock(compressMutex);
+            if (!compressorRunning) return;
+            compressorRunning = false;
+        }
+        
+        // The compressor finishes every queued generation before it exits
+        compressWake.notify_one();
+        compressorThread.join();
+    }
+    
+    void runCompressor() {
+#ifdef __linux__
+        // Lowest CPU priority for this thread only, so compression never competes with the writer
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+#endif
+        unique_lock<mutex> lock(compressMutex);
+        
+        // Loop - compress rotated generations one at a time
+        while (true) {
+            compressWake.wait(lock, [this]() { return !compressQueue.empty() || !compressorRunning; });
+            if (compressQueue.empty()) break;
+            
+            string path = compressQueue.front();
+            compressQueue.pop_front();
+            lock.unlock();
+            bool compressed = compressFile(path, path + ".gz.tmp");
+            lock.lock();
+            
+            // Decision making - publish under the lock so pruning never races the final rename
+            if (compressed) {
+                long long generation = stoll(path.substr(logPath.size() + 1));
+                if (generation >= oldestRetainedGeneration) {
+                    rename((path + ".gz.tmp").c_str(), (path + ".gz").c_str());
+                    compressedCount++;
+                } else {
+                    remove((path + ".gz.tmp").c_str());
+                }
+                remove(path.c_str());
+            }
+        }
+    }
+    
+    static bool compressFile(const string& source, const string& destination) {
+        // IO call - stream the generation through zlib into a temporary .gz
+        ifstream in(source, ios::binary);
+        if (!in.is_open()) return false;
+        gzFile out = gzopen(destination.c_str(), "wb6");
+        if (!out) return false;
+        
+        vector<char> chunk(64 * 1024);
+        bool success = true;
+        while (success && in) {
+            in.read(chunk.data(), chunk.size());
+            streamsize count = in.gcount();
+            if (count > 0 && gzwrite(out, chunk.data(), static_cast<unsigned>(count)) != count) {
+                success = false;
+            }
+        }
+        
+        if (gzclose(out) != Z_OK) success = false;
+        if (!success) remove(destination.c_str());
+        return success;
+    }
+    
+    bool enterAsyncProducer() {
+        // Register before re-checking the mode, so stopAsync either sees this caller or the caller sees it stopped
+        if (!asyncRunning.load(memory_order_acquire)) return false;
+        asyncProducers.fetch_add(1);
+        if (asyncRunning.load()) return true;
+        asyncProducers.fetch_sub(1);
+        return false;
+    }
+    
+    void leaveAsyncProducer() {
+        asyncProducers.fetch_sub(1);
+    }
+    
+    template <typename... Args>
+    void logDeferredNow(uint32_t formatId, LogLevel level, size_t size, const Args&... args) {
+        // Encode and render on the caller, then log the text like log()
+        vector<char> scratch(size);
+        char* cursor = scratch.data();
+        ((cursor = DeferredCodec::encode(cursor, args)), ...);
+        
+        LogFormat format;
+        if (!LogFormatRegistry::find(formatId, format)) return;
+        string message;
+        DeferredCodec::render(message, format.format, scratch.data(), cursor);
+        log(level, message);
+    }
+    
+    AsyncPush enqueueAsync(LogRecord& record) {
+        // Decision making - shed DEBUG/INFO early so WARNING and above keep headroom
+        bool lowerLevel = record.level < LogLevel::Warning;
+        if (overflowPolicy == OverflowPolicy::DropLowerLevels && lowerLevel &&
+            asyncRing->size() >= asyncRing->capacity() * 3 / 4) {
+            droppedCount++;
+            return AsyncPush::Dropped;
+        }
+        
+        if (!asyncRing->tryPush(record)) {
+            if (overflowPolicy == OverflowPolicy::Drop || (overflowPolicy == OverflowPolicy::DropLowerLevels && lowerLevel)) {
+                droppedCount++;
+                return AsyncPush::Dropped;
+            }
+            
+            // Loop - Block policy: wait for the writer to free a slot, unless async mode is being stopped
+            blockedCount++;
+            do {
+                if (!asyncRunning.load(memory_order_acquire)) return AsyncPush::Stopped;
+                wakeAsyncWriter();
+                this_thread::yield();
+            } while (!asyncRing->tryPush(record));
+        }
+        
+        asyncPushed++;
+        
+        // Only wake a parked writer once the ring is half full; otherwise its poll interval picks the message up
+        if (asyncWriterIdle.load(memory_order_acquire) && asyncRing->size() >= asyncRing->capacity() / 2) {
+            wakeAsyncWriter();
+        }
+        return AsyncPush::Queued;
+    }
+    
+    void wakeAsyncWriter() {
+        {
+            lock_guard<mutex> lock(asyncWakeMutex);
+        }
+        asyncWake.notify_one();
+    }
+    
+    void runAsyncWriter() {
+        string batch;
+        batch.reserve(asyncBatchBytes + 1024);
+        
+        // Loop - drain the ring into one buffer, then hand the buffer to each sink in a single write
+        while (true) {
+            long long popped = 0;
+            while (batch.size() < asyncBatchBytes && asyncRing->tryPop([this, &batch](const LogRecord& record) {
+                formatRecord(batch, record.message, record.level, record.time, record.thread);
+                batch += '\n';
+            })) {
+                popped++;
+            }
+            size_t deferred = drainDeferred(batch);
+            
+            if (popped > 0 || deferred > 0) {
+                if (!batch.empty()) writeBatch(batch);
+                batch.clear();
+                asyncWritten += popped;
+                {
+                    lock_guard<mutex> lock(asyncWakeMutex);
+                }
+                asyncDrained.notify_all();
+                continue;
+            }
+            
+            if (!asyncRunning.load(memory_order_acquire) && asyncRing->size() == 0) break;
+            
+            // Decision making - park for one poll interval so the next batch can accumulate
+            unique_lock<mutex> lock(asyncWakeMutex);
+            asyncWriterIdle.store(true, memory_order_release);
+            if (asyncRunning) {
+                asyncWake.wait_for(lock, asyncPollInterval);
+            }
+            asyncWriterIdle.store(false, memory_order_release);
+        }
+    }
+    
+    static uint64_t nextInstanceId() {
+        static atomic<uint64_t> next(1);
+        return next++;
+    }
+    
+    DeferredBuffer* deferredBuffer() {
+        // One-entry cache in front of the per-thread map keeps the common case to a compare
+        struct ThreadBuffers {
+            uint64_t lastOwner = 0;
+            DeferredBuffer* lastBuffer = nullptr;
+            unordered_map<uint64_t, shared_ptr<DeferredBuffer>> byLogger;
+            
+            ~ThreadBuffers() {
+                for (auto& entry : byLogger) {
+                    entry.second->retired = true;
+                }
+            }
+        };
+        static thread_local ThreadBuffers buffers;
+        
+        if (buffers.lastOwner == instanceId) return buffers.lastBuffer;
+        
+        shared_ptr<DeferredBuffer>& buffer = buffers.byLogger[instanceId];
+        if (!buffer) {
+            buffer = make_shared<DeferredBuffer>(deferredBufferBytes, ThreadTag::currentHash());
+            lock_guard<mutex> lock(deferredMutex);
+            deferredBuffers.push_back(buffer);
+        }
+        buffers.lastOwner = instanceId;
+        buffers.lastBuffer = buffer.get();
+        return buffer.get();
+    }
+    
+    size_t drainDeferred(string& batch) {
+        vector<shared_ptr<DeferredBuffer>> buffers;
+        {
+            lock_guard<mutex> lock(deferredMutex);
+            buffers = deferredBuffers;
+        }
+        
+        // Decision making - binary records are copied and written under logMutex, so startBinaryLog
+        // cannot swap the file or its format table between a definition and the records using it
+        unique_lock<mutex> binaryLock(logMutex);
+        bool binary = binaryLog.is_open();
+        if (!binary) binaryLock.unlock();
+        
+        size_t records = 0;
+        string message;
+        string binaryBatch;
+        
+        // Loop - render each thread's records as text, or copy them raw into the binary log
+        for (const auto& buffer : buffers) {
+            bool retired = buffer->retired.load();
+            ThreadTag thread = ThreadTag::fromHash(buffer->threadHash);
+            
+            records += buffer->drain([&](const DeferredHeader& header, const char* args, const char* end) {
+                LogFormat format;
+                if (!LogFormatRegistry::find(header.formatId, format)) return;
+                updateStats(header.level);
+                
+                if (binary) {
+                    appendBinaryRecord(binaryBatch, header, buffer->threadHash, format, args, end);
+                    return;
+                }
+                
+                message.clear();
+                DeferredCodec::render(message, format.format, args, end);
+                formatRecord(batch, message, header.level,
+                             chrono::system_clock::time_point(chrono::duration_cast<chrono::system_clock::duration>(
+                                 chrono::nanoseconds(header.timestampNs))),
+                             thread);
+                batch += '\n';
+            });
+            
+            // Decision making - forget buffers of exited threads once they are empty
+            if (retired && buffer->consumed() >= buffer->written()) {
+                lock_guard<mutex> lock(deferredMutex);
+                deferredBuffers.erase(remove(deferredBuffers.begin(), deferredBuffers.end(), buffer), deferredBuffers.end());
+            }
+        }
+        
+        // IO call - one write for every raw record of this pass
+        if (binary && !binaryBatch.empty()) {
+            binaryLog.write(binaryBatch.data(), binaryBatch.size());
+            binaryLog.flush();
+        }
+        return records;
+    }
+    
+    // Caller holds logMutex
+    void appendBinaryRecord(string& out, const DeferredHeader& header, uint64_t threadHash, const LogFormat& format,
+                            const char* args, const char* end) {
+        // The first record of each format is preceded by its definition
+        if (header.formatId >= formatsInBinaryLog.size()) {
+            formatsInBinaryLog.resize(header.formatId + 1, false);
+        }
+        if (!formatsInBinaryLog[header.formatId]) {
+            uint32_t length = static_cast<uint32_t>(strlen(format.format));
+            uint32_t definition[3] = {binaryFormatMarker, static_cast<uint32_t>(3 * sizeof(uint32_t) + length), header.formatId};
+            out.append(reinterpret_cast<const char*>(definition), sizeof(definition));
+            out.append(format.format, length);
+            formatsInBinaryLog[header.formatId] = true;
+        }
         
-        stringstream ss;
-        ss << put_time(localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-        ss << "." << setfill('0') << setw(3) << ms.count();
+        uint32_t level = static_cast<uint32_t>(header.level);
+        uint32_t prefix[2] = {header.formatId, static_cast<uint32_t>(2 * sizeof(uint32_t) + sizeof(header.timestampNs) +
+                                                                    sizeof(threadHash) + sizeof(level) + (end - args))};
+        out.append(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+        out.append(reinterpret_cast<const char*>(&header.timestampNs), sizeof(header.timestampNs));
+        out.append(reinterpret_cast<const char*>(&threadHash), sizeof(threadHash));
+        out.append(reinterpret_cast<const char*>(&level), sizeof(level));
+        out.append(args, end);
+    }
+    
+    void writeBatch(const string& batch) {
+        lock_guard<mutex> lock(logMutex);
+        batchCount++;
+        
+        // IO call - one write per sink for the whole batch
+        if (fileLoggingEnabled && logFile.is_open()) {
+            logFile.write(batch.data(), batch.size());
+            logFile.flush();
+            currentFileBytes += batch.size();
+            
+            // Decision making - the writer thread rotates between batches
+            if (shouldRotateLocked()) {
+                rotateLocked();
+            }
+        }
+        if (consoleLoggingEnabled) {
+            cout.write(batch.data(), batch.size());
+            cout.flush();
+        }
+    }
+    
+    static void formatRecord(string& out, const string& message, LogLevel level,
+                             chrono::system_clock::time_point now, const ThreadTag& thread) {
+        // Calculation - the "[YYYY-MM-DD HH:MM:SS." prefix is rendered once per second per formatting thread
+        struct SecondPrefix {
+            time_t second = -1;
+            char text[32];
+            size_t length = 0;
+        };
+        static thread_local SecondPrefix prefix;
         
-        // Calculation - thread ID
-        thread::id threadId = this_thread::get_id();
+        long long sinceEpochMs = chrono::duration_cast<chrono::milliseconds>(now.time_since_epoch()).count();
+        time_t second = static_cast<time_t>(sinceEpochMs / 1000);
+        int millis = static_cast<int>(sinceEpochMs % 1000);
         
-        // Decision making - format based on level
-        string levelStr = "[" + level + "]";
-        string timestamp = "[" + ss.str() + "]";
-        string threadStr = "[Thread-" + to_string(hash<thread::id>{}(threadId)) + "]";
+        if (second != prefix.second) {
+            tm local;
+            localtime_r(&second, &local);
+            prefix.length = strftime(prefix.text, sizeof(prefix.text), "[%Y-%m-%d %H:%M:%S.", &local);
+            prefix.second = second;
+        }
         
-        return timestamp + " " + levelStr + " " + threadStr + " " + message;
+        // Append straight into the caller's buffer - no intermediate strings
+        const char* name = levelName(level);
+        out.reserve(out.size() + prefix.length + 8 + strlen(name) + thread.length + message.size());
+        out.append(prefix.text, prefix.length);
+        out += static_cast<char>('0' + millis / 100);
+        out += static_cast<char>('0' + millis / 10 % 10);
+        out += static_cast<char>('0' + millis % 10);
+        out.append("] [", 3);
+        out.append(name);
+        out.append("] ", 2);
+        out.append(thread.text, thread.length);
+        out += ' ';
+        out.append(message);
     }
     
     void flushQueue() {
@@ -219,41 +1393,49 @@ private:
             logQueue.pop();
             
             // IO call - write to file
-            if (enableFileLogging && logFile.is_open()) {
+            if (fileLoggingEnabled && logFile.is_open()) {
                 logFile << message << endl;
                 logFile.flush();
+                currentFileBytes += message.size() + 1;
+                
+                if (shouldRotateLocked()) {
+                    rotateLocked();
+                }
             }
             
             // IO call - write to console
-            if (enableConsoleLogging) {
+            if (consoleLoggingEnabled) {
                 cout << message << endl;
             }
         }
     }
     
-    void updateStats(const string& level) {
+    void updateStats(LogLevel level) {
         totalLogs++;
         
         // Decision making - update specific counters
-        if (level == "ERROR" || level == "CRITICAL") {
+        if (level >= LogLevel::Error) {
             errorCount++;
-        } else if (level == "WARNING") {
+        } else if (level == LogLevel::Warning) {
             warningCount++;
         }
     }
     
     void cleanupOldLogs(int daysOld) {
-        // Decision making - cleanup old log files
-        if (logFile.is_open()) {
-            logFile.close();
-        }
+        // Decision making - remove rotated generations last modified before the cutoff
+        time_t cutoff = time(nullptr) - static_cast<time_t>(daysOld) * 24 * 60 * 60;
+        lock_guard<mutex> lock(compressMutex);
         
-        // IO call - remove old backup files
-        string backupName = logPath + ".backup";
-        remove(backupName.c_str());
-        
-        openLogFile();
-        log("Old log files cleaned up", "INFO");
+        // Loop - IO call - remove old generation files, compressed or not
+        for (long long generation : findGenerations()) {
+            string base = logPath + "." + to_string(generation);
+            for (const string& candidate : {base, base + ".gz"}) {
+                struct stat info;
+                if (stat(candidate.c_str(), &info) == 0 && info.st_mtime < cutoff) {
+                    remove(candidate.c_str());
+                }
+            }
+        }
     }
     
     double calculateErrorRate() {
@@ -262,23 +1444,21 @@ private:
     }
     
     bool shouldRotateLog() {
-        // Decision making - check if log rotation is needed
-        if (logFile.is_open()) {
-            streampos fileSize = logFile.tellp();
-            return fileSize > 5 * 1024 * 1024; // 5MB
-        }
-        return false;
+        // Decision making - check if log rotation is needed, against the same policy the writer uses
+        lock_guard<mutex> lock(logMutex);
+        return shouldRotateLocked();
     }
     
-    void performLogRotation() {
-        if (shouldRotateLog()) {
-            rotateLogFile();
-        }
-    }
 };
 
 // Main function to demonstrate Logger
-int main() {
+// Usage: logger_demo [--decode <binary log>]
+int main(int argc, char* argv[]) {
+    // Offline decoder mode - render a binary log written by startBinaryLog
+    if (argc == 3 && string(argv[1]) == "--decode") {
+        return Logger::decodeBinaryLog(argv[2], cout) ? 0 : 1;
+    }
+    
     cout << "=== Logger Demo ===" << endl;
     
     Logger logger("demo_log.txt");
@@ -309,6 +1489,24 @@ int main() {
         cout << "---" << endl;
     }
     
+    // Test filtered-out calls - macros skip building the message, the string API builds it first
+    cout << "\n--- Level Filtering ---" << endl;
+    logger.setLogLevel(LogLevel::Warning);
+    const int filteredCalls = 1000000;
+    auto macroStart = chrono::steady_clock::now();
+    for (int i = 0; i < filteredCalls; ++i) {
+        LOG_INFO(logger, "Filtered entry " + to_string(i));
+    }
+    auto macroEnd = chrono::steady_clock::now();
+    for (int i = 0; i < filteredCalls; ++i) {
+        logger.logInfo("Filtered entry " + to_string(i));
+    }
+    auto stringEnd = chrono::steady_clock::now();
+    cout << "Filtered LOG_INFO: " << chrono::duration<double, nano>(macroEnd - macroStart).count() / filteredCalls
+         << " ns, filtered logInfo(string): " << chrono::duration<double, nano>(stringEnd - macroEnd).count() / filteredCalls
+         << " ns" << endl;
+    cout << "Compile-time minimum level: " << Logger::levelName(static_cast<LogLevel>(LOGGER_MIN_LEVEL)) << endl;
+    
     // Reset to INFO level
     logger.setLogLevel("INFO");
     
@@ -335,9 +1533,24 @@ int main() {
     logger.enableConsoleLogging(true);
     logger.logInfo("This message should appear in both console and file");
     
-    // Test log rotation
+    // Test log rotation - a small size limit forces several rotations; older generations are compressed
     cout << "\n--- Log Rotation ---" << endl;
-    logger.rotateLogFile();
+    RotationPolicy smallFiles;
+    smallFiles.maxBytes = 4 * 1024;
+    smallFiles.generations = 3;
+    logger.setRotationPolicy(smallFiles);
+    logger.enableConsoleLogging(false);
+    for (int i = 1; i <= 300; ++i) {
+        logger.logInfo("Rotation filler line " + to_string(i));
+    }
+    logger.flush();
+    logger.enableConsoleLogging(true);
+    logger.setRotationPolicy(RotationPolicy());
+    this_thread::sleep_for(chrono::milliseconds(100));
+    
+    auto rotationStats = logger.getLogStats();
+    cout << "Rotations: " << rotationStats["rotations"] << ", compressed generations: "
+         << rotationStats["compressed"] << " (3 kept)" << endl;
     
     // Test performance logging
     cout << "\n--- Performance Logging ---" << endl;
@@ -388,6 +1601,49 @@ int main() {
     }
     logger.flush();
     
+    // Test asynchronous logging - callers only format and push into the ring
+    cout << "\n--- Async Logging ---" << endl;
+    logger.startAsync(8192, OverflowPolicy::Block);
+    logger.enableConsoleLogging(false);
+    const int asyncMessages = 5000; // fits in the ring, so this measures caller cost rather than writer throughput
+    auto asyncStart = chrono::steady_clock::now();
+    for (int i = 1; i <= asyncMessages; ++i) {
+        logger.logInfo("Async log entry " + to_string(i));
+    }
+    auto asyncEnd = chrono::steady_clock::now();
+    logger.flush();
+    logger.enableConsoleLogging(true);
+    
+    auto asyncStats = logger.getLogStats();
+    double nsPerCall = chrono::duration<double, nano>(asyncEnd - asyncStart).count() / asyncMessages;
+    cout << "Caller cost: " << fixed << setprecision(0) << nsPerCall << " ns per message, "
+         << asyncStats["async_batches"] << " batched writes, " << asyncStats["blocked"] << " blocked" << endl;
+    cout.unsetf(ios::fixed);
+    
+    // Test deferred logging - only the format id and raw arguments are copied on the caller
+    cout << "\n--- Deferred Logging ---" << endl;
+    logger.enableConsoleLogging(false);
+    auto deferredStart = chrono::steady_clock::now();
+    for (int i = 1; i <= asyncMessages; ++i) {
+        LOG_DEFERRED(logger, LogLevel::Info, "Processing batch {} of {} ({} ms)", i, asyncMessages, 0.25 * i);
+    }
+    auto deferredEnd = chrono::steady_clock::now();
+    logger.flush();
+    logger.enableConsoleLogging(true);
+    cout << "Caller cost: " << fixed << setprecision(0)
+         << chrono::duration<double, nano>(deferredEnd - deferredStart).count() / asyncMessages << " ns per message" << endl;
+    cout.unsetf(ios::fixed);
+    
+    // Binary log - records stay unrendered until decoded offline (logger_demo --decode demo_log.bin)
+    if (logger.startBinaryLog("demo_log.bin")) {
+        for (int i = 1; i <= 3; ++i) {
+            LOG_DEFERRED(logger, LogLevel::Warning, "Replica {} lagging by {} bytes on {}", i, 4096 * i, string("db-primary"));
+        }
+        logger.stopBinaryLog();
+        cout << "Decoded binary log:" << endl;
+        Logger::decodeBinaryLog("demo_log.bin", cout);
+    }
+    
     // Test different message types
     cout << "\n--- Message Types ---" << endl;
     logger.logInfo("User login: admin@example.com");